@@ -0,0 +1,81 @@
+## This file is part of Simple_OS, a real-time operating system
+## designed for research and education
+## Copyright (c) 2003-2013 Ola Dahl
+
+## The software accompanies the book Into Realtime, available at
+## http://theintobooks.com
+
+## Simple_OS is free software: you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+
+## This program is distributed in the hope that it will be useful,
+## but WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+
+## You should have received a copy of the GNU General Public License
+## along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+## Task switch for the 64-bit x86 host. The saved registers 
+## are the callee-saved registers of the System V AMD64 ABI. 
+## The other registers are saved by the calling C code. 
+
+.text
+
+.globl context_restore
+
+# fig_begin context_restore_x86_64
+context_restore:
+        # copy parameter value to rsp  
+        movq %rdi, %rsp
+        # restore registers
+        popq %rbp
+        popq %rbx
+        popq %r12
+        popq %r13
+        popq %r14
+        popq %r15
+        # restore pc
+        ret
+# fig_end context_restore_x86_64
+
+.globl context_switch
+
+# fig_begin context_switch_x86_64
+context_switch:
+        # save registers
+        pushq %r15
+        pushq %r14
+        pushq %r13
+        pushq %r12
+        pushq %rbx
+        pushq %rbp
+        # copy rsp to address referred to by 
+        # first parameter
+        movq %rsp, (%rdi)
+        # switch stack, copying new stack 
+        # pointer in second parameter to rsp
+        movq %rsi, %rsp
+        # restore registers
+        popq %rbp
+        popq %rbx
+        popq %r12
+        popq %r13
+        popq %r14
+        popq %r15
+        # restore pc
+        ret
+# fig_end context_switch_x86_64
+
+.globl context_align
+
+# context_align: returns to the address on top of the 
+# stack, and is used when a task is started, so that the 
+# task function is entered with the stack aligned as 
+# after a call instruction
+context_align:
+        ret
+
+.section .note.GNU-stack,"",@progbits
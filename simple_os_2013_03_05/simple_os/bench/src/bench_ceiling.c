@@ -0,0 +1,180 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_ceiling: measures the cost of a lock and unlock pair, 
+   for a plain semaphore, for a semaphore with priority ceiling, 
+   where the priority of the task is raised and restored, and 
+   for a mutex with priority inheritance. The priority of a task 
+   holding two semaphores with ceilings is checked, when they are 
+   released in the reverse order of taking, and out of order, and 
+   when a semaphore with ceiling is signalled by another task. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of lock and unlock pairs in each measurement */ 
+#define N_CALLS 1000000
+
+/* stack size for the benchmark task */ 
+#define STACK_SIZE 10000
+
+/* priority for the benchmark task */ 
+#define BENCH_PRIORITY 20
+
+/* ceiling priority, higher than the priority 
+   of the benchmark task */ 
+#define CEILING_PRIORITY 10
+
+/* ceiling priority, higher than CEILING_PRIORITY, 
+   for nested semaphores */ 
+#define INNER_CEILING_PRIORITY 5
+
+/* priority for the task which signals a semaphore 
+   held by the benchmark task */ 
+#define SIGNAL_PRIORITY 30
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+
+static si_semaphore Plain_Sem; 
+static si_semaphore Ceiling_Sem; 
+static si_mutex Mutex; 
+static si_semaphore Inner_Sem; 
+
+/* the task id of the benchmark task */ 
+static int Bench_Task_Id; 
+
+/* measure_sem: returns the time for a 
+   wait and signal pair on sem, in ns */ 
+static double measure_sem(si_semaphore *sem)
+{
+    long long t_start, t_end; 
+    long n; 
+
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_CALLS; n++)
+    {
+        si_sem_wait(sem); 
+        si_sem_signal(sem); 
+    }
+    t_end = bench_util_get_time_ns(); 
+    return bench_util_ns_per_item(t_start, t_end, N_CALLS); 
+}
+
+/* measure_mutex: returns the time for a 
+   lock and unlock pair on mutex, in ns */ 
+static double measure_mutex(si_mutex *mutex)
+{
+    long long t_start, t_end; 
+    long n; 
+
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_CALLS; n++)
+    {
+        si_mutex_lock(mutex); 
+        si_mutex_unlock(mutex); 
+    }
+    t_end = bench_util_get_time_ns(); 
+    return bench_util_ns_per_item(t_start, t_end, N_CALLS); 
+}
+
+/* get_priority: returns the current priority of task_id */ 
+static int get_priority(int task_id)
+{
+    si_task_stats stats; 
+
+    si_task_get_stats(task_id, &stats); 
+    return stats.priority; 
+}
+
+/* check_nested: takes Ceiling_Sem and then Inner_Sem, and 
+   releases them in the reverse order, if reverse is nonzero, 
+   and otherwise out of order, and prints the priority after 
+   each step */ 
+static void check_nested(int reverse)
+{
+    int task_id = si_task_get_id(); 
+
+    printf("%-8s  ", reverse ? "reverse" : "out"); 
+    si_sem_wait(&Ceiling_Sem); 
+    printf("%4d", get_priority(task_id)); 
+    si_sem_wait(&Inner_Sem); 
+    printf("%4d", get_priority(task_id)); 
+    si_sem_signal(reverse ? &Inner_Sem : &Ceiling_Sem); 
+    printf("%4d", get_priority(task_id)); 
+    si_sem_signal(reverse ? &Ceiling_Sem : &Inner_Sem); 
+    printf("%4d\n", get_priority(task_id)); 
+}
+
+/* signal_task: signals Ceiling_Sem, which is held by 
+   the benchmark task, and prints its priority */ 
+static void signal_task(void)
+{
+    si_sem_signal(&Ceiling_Sem); 
+    printf("signalled by other task: %d\n", get_priority(Bench_Task_Id)); 
+}
+
+static void bench_task(void)
+{
+    /* the stack of the task which signals Ceiling_Sem */ 
+    static stack_item signal_stack[STACK_SIZE]; 
+
+    printf("release   priority after wait, wait, signal, signal\n"); 
+    check_nested(1); 
+    check_nested(0); 
+
+    /* the priority of the holder is kept, when another task 
+       signals, until the holder signals */ 
+    si_sem_wait(&Ceiling_Sem); 
+    si_task_create(signal_task, &signal_stack[STACK_SIZE-1], SIGNAL_PRIORITY); 
+    si_wait_n_ms(100); 
+    si_sem_signal(&Ceiling_Sem); 
+    printf("signalled by holder: %d\n", get_priority(Bench_Task_Id)); 
+    /* Ceiling_Sem was signalled twice, restore its count to 1 */ 
+    si_sem_wait(&Ceiling_Sem); 
+    si_sem_signal(&Ceiling_Sem); 
+
+    printf("lock             lock_unlock_ns\n"); 
+    printf("semaphore        %14.1f\n", measure_sem(&Plain_Sem)); 
+    printf("ceiling          %14.1f\n", measure_sem(&Ceiling_Sem)); 
+    printf("mutex            %14.1f\n", measure_mutex(&Mutex)); 
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    si_sem_init(&Plain_Sem, 1); 
+    si_sem_init_ceiling(&Ceiling_Sem, 1, CEILING_PRIORITY); 
+    si_mutex_init(&Mutex); 
+    si_sem_init_ceiling(&Inner_Sem, 1, INNER_CEILING_PRIORITY); 
+
+    Bench_Task_Id = si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], BENCH_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
@@ -0,0 +1,142 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+/* bench_edf: runs a synthetic set of periodic tasks, with a 
+   total utilisation of 0.9, and reports deadline misses and 
+   release jitter for each task. The task set can not be 
+   scheduled with rate monotonic fixed priorities, but can be 
+   scheduled with EDF. Build the benchmark with and without 
+   EDF_SCHEDULING, i.e. for x86_host and x86_host_edf, to 
+   compare the two. */ 
+
+#include "simple_os.h"
+
+#include "interrupt.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* run time, in milliseconds */ 
+#define RUN_MS 5000
+
+/* tick rate for the benchmark */ 
+#define TICK_RATE_HZ 1000
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 5000
+
+/* the periodic tasks, with period and execution time in 
+   milliseconds, in rate monotonic priority order */ 
+typedef struct
+{
+    int period_ms; 
+    int wcet_ms; 
+} task_params; 
+
+static const task_params Task_Set[] = {{10, 4}, {14, 7}}; 
+
+#define N_WORKERS (sizeof(Task_Set) / sizeof(Task_Set[0]))
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+
+static stack_item Worker_Stack[N_WORKERS][STACK_SIZE]; 
+
+/* task ids for the periodic tasks */ 
+static int Worker_Task_Id[N_WORKERS]; 
+
+/* index of the next periodic task to start */ 
+static int Next_Worker; 
+
+/* worker_task: a periodic task, which executes 
+   for its execution time in each period */ 
+static void worker_task(void)
+{
+    /* the index of this task */ 
+    int index; 
+
+    DISABLE_INTERRUPTS; 
+    index = Next_Worker++; 
+    ENABLE_INTERRUPTS; 
+
+    si_task_periodic(Task_Set[index].period_ms, 0); 
+    while (1)
+    {
+        bench_util_do_work_ms(Task_Set[index].wcet_ms); 
+        si_wait_next_period(); 
+    }
+}
+
+static void bench_task(void)
+{
+    /* statistics for a periodic task */ 
+    si_periodic_stats stats; 
+
+    unsigned int i; 
+
+    si_wait_n_ms(RUN_MS); 
+
+#ifdef EDF_SCHEDULING
+    printf("scheduling: EDF\n"); 
+#else
+    printf("scheduling: fixed priority, rate monotonic\n"); 
+#endif
+    printf("period_ms  wcet_ms  releases  deadline_misses  overruns"
+           "  mean_jitter_us  max_jitter_us\n"); 
+    for (i = 0; i < N_WORKERS; i++)
+    {
+        si_task_get_periodic_stats(Worker_Task_Id[i], &stats); 
+        printf("%9d  %7d  %8d  %15d  %8d  %14ld  %13ld\n", 
+               Task_Set[i].period_ms, Task_Set[i].wcet_ms, 
+               stats.n_releases, stats.n_deadline_misses, 
+               stats.n_overruns, stats.mean_jitter_us, 
+               stats.max_jitter_us); 
+    }
+
+    exit(0); 
+}
+
+int main(void)
+{
+    unsigned int i; 
+
+    bench_util_calibrate_work(); 
+
+    /* initialise kernel */ 
+    si_kernel_init(); 
+    si_kernel_set_tick_rate(TICK_RATE_HZ); 
+
+    /* create the benchmark task, with highest priority */ 
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], 0); 
+
+    /* create the periodic tasks */ 
+    for (i = 0; i < N_WORKERS; i++)
+    {
+        Worker_Task_Id[i] = si_task_create(worker_task, 
+            &Worker_Stack[i][STACK_SIZE-1], 10 + i); 
+    }
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
@@ -0,0 +1,307 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_fpu: measures the cost of a kernel task switch, for 
+   a mix of integer-only tasks and tasks using floating 
+   point, and checks that the rounding mode set by each 
+   floating point task is kept. A benchmark task signals a 
+   partner task, which signals back, and each task sets its 
+   own rounding mode. Without private FPU contexts, the tasks 
+   see each other's rounding mode. Finally, a task which is 
+   woken by the timer interrupt alternately preempts a 
+   computing task, and wakes a task which waits, and the 
+   rounding modes, in the FPU and in MXCSR, are checked. */ 
+
+#include "simple_os.h"
+
+#include "fpu.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fenv.h>
+
+/* number of round trips in each measurement, 
+   with two task switches per round trip */ 
+#define N_ROUND_TRIPS 200000
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 5000
+
+/* number of rounds, and the time in ms between them, 
+   in the measurement with preemption */ 
+#define N_PREEMPT_ROUNDS 100
+#define PREEMPT_PERIOD_MS 10
+
+/* priorities for the tasks in the measurement with preemption, 
+   where the timer task has the highest priority */ 
+#define TIMER_TASK_PRIORITY 3
+#define PREEMPTED_TASK_PRIORITY 8
+
+/* a partner task, and the tasks in a measurement */ 
+typedef struct
+{
+    /* description of the task mix */ 
+    const char *mix; 
+    /* nonzero if the benchmark task uses floating point, 
+       and if it has a private FPU context */ 
+    int bench_uses_fp; 
+    int bench_uses_fpu_context; 
+    /* the same, for the partner task */ 
+    int partner_uses_fp; 
+    int partner_uses_fpu_context; 
+    /* semaphores for signalling the partner task, and back */ 
+    si_semaphore ping_sem; 
+    si_semaphore pong_sem; 
+    /* number of times the partner saw a wrong rounding mode */ 
+    long n_errors; 
+} measurement_type; 
+
+/* the measurements. FPU contexts are never released, so 
+   the measurement where floating point is used without FPU 
+   contexts comes before any FPU context is used, and the 
+   measurement where the benchmark task has an FPU context 
+   comes last. */ 
+static measurement_type Measurement[] = 
+{
+    {"int/int", 0, 0, 0, 0}, 
+    {"fp/fp, no fpu context", 1, 0, 1, 0}, 
+    {"int/fp", 0, 0, 1, 1}, 
+    {"fp/fp", 1, 1, 1, 1}, 
+}; 
+
+#define N_MEASUREMENTS (sizeof(Measurement) / sizeof(Measurement[0]))
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+
+static stack_item Partner_Stack[N_MEASUREMENTS][STACK_SIZE]; 
+
+/* index of the next partner task to start */ 
+static int Next_Partner; 
+
+static stack_item Timer_Task_Stack[STACK_SIZE]; 
+static stack_item Preempted_Task_Stack[STACK_SIZE]; 
+
+/* the round in the measurement with preemption, 
+   set by the timer task */ 
+static volatile int Preempt_Round; 
+
+/* signalled by the timer task at each round, and 
+   when the measurement is done */ 
+static si_semaphore Round_Sem; 
+static si_semaphore Preempt_Done_Sem; 
+
+/* number of times the timer task, and the preempted 
+   task, saw a wrong rounding mode */ 
+static long N_Timer_Task_Errors; 
+static long N_Preempted_Task_Errors; 
+
+/* get_mxcsr_round: returns the rounding mode in MXCSR, 
+   using the same encoding as fegetround */ 
+static int get_mxcsr_round(void)
+{
+    unsigned int mxcsr; 
+
+    __asm__ volatile ("stmxcsr %0" : "=m" (mxcsr)); 
+    /* the rounding control is bits 13 and 14 in MXCSR, and 
+       bits 10 and 11 in the x87 control word */ 
+    return (mxcsr >> 3) & 0xC00; 
+}
+
+/* check_round: returns 1 if the rounding mode, in the FPU 
+   or in MXCSR, is not round, which then is set again, 
+   and otherwise 0 */ 
+static int check_round(int round)
+{
+    if (fegetround() != round || get_mxcsr_round() != round)
+    {
+        fesetround(round); 
+        return 1; 
+    }
+    return 0; 
+}
+
+/* timer_task: is woken by the timer interrupt, and starts 
+   a new round for preempted_task */ 
+static void timer_task(void)
+{
+    int i; 
+
+    si_task_use_fpu(); 
+    fesetround(FE_UPWARD); 
+    for (i = 1; i <= N_PREEMPT_ROUNDS; i++)
+    {
+        si_wait_n_ms(PREEMPT_PERIOD_MS); 
+        N_Timer_Task_Errors += check_round(FE_UPWARD); 
+        Preempt_Round = i; 
+        si_sem_signal(&Round_Sem); 
+    }
+    /* end the computing in the last round */ 
+    Preempt_Round = N_PREEMPT_ROUNDS + 1; 
+    si_sem_signal(&Preempt_Done_Sem); 
+}
+
+/* preempted_task: computes during even rounds, so that it is 
+   preempted when the timer task is woken, and waits for 
+   Round_Sem during odd rounds, so that the timer task is 
+   woken from the idle task */ 
+static void preempted_task(void)
+{
+    /* the round when computing started */ 
+    int round; 
+    /* nonzero when a wrong rounding mode has been seen in 
+       this round */ 
+    int error; 
+
+    si_task_use_fpu(); 
+    fesetround(FE_DOWNWARD); 
+    while (1)
+    {
+        si_sem_wait(&Round_Sem); 
+        N_Preempted_Task_Errors += check_round(FE_DOWNWARD); 
+        round = Preempt_Round; 
+        error = 0; 
+        while (round % 2 == 0 && Preempt_Round == round)
+        {
+            if (!error && check_round(FE_DOWNWARD))
+            {
+                error = 1; 
+                N_Preempted_Task_Errors++; 
+            }
+        }
+    }
+}
+
+/* partner_task: answers each signal from the benchmark 
+   task, and checks its rounding mode if it uses 
+   floating point */ 
+static void partner_task(void)
+{
+    /* the measurement for this task */ 
+    measurement_type *m = &Measurement[Next_Partner++]; 
+
+    if (m->partner_uses_fpu_context)
+    {
+        si_task_use_fpu(); 
+    }
+    if (m->partner_uses_fp)
+    {
+        fesetround(FE_DOWNWARD); 
+    }
+    while (1)
+    {
+        si_sem_wait(&m->ping_sem); 
+        if (m->partner_uses_fp && fegetround() != FE_DOWNWARD)
+        {
+            m->n_errors++; 
+            fesetround(FE_DOWNWARD); 
+        }
+        si_sem_signal(&m->pong_sem); 
+    }
+}
+
+static void bench_task(void)
+{
+    /* time stamps */ 
+    long long t_start, t_end; 
+    /* number of FPU context switches before a measurement */ 
+    long n_fpu_switches; 
+    /* number of wrong rounding modes seen by this task */ 
+    long n_errors; 
+
+    measurement_type *m; 
+    unsigned int i; 
+    long n; 
+
+    printf("mix                    switch_ns  fpu_switches  errors\n"); 
+    for (i = 0; i < N_MEASUREMENTS; i++)
+    {
+        m = &Measurement[i]; 
+        /* create the partner task, with higher priority, 
+           so that it runs until it waits for a signal */ 
+        si_task_create(partner_task, 
+            &Partner_Stack[i][STACK_SIZE-1], 5); 
+        if (m->bench_uses_fpu_context)
+        {
+            si_task_use_fpu(); 
+        }
+        if (m->bench_uses_fp)
+        {
+            fesetround(FE_UPWARD); 
+        }
+        n_errors = 0; 
+        n_fpu_switches = fpu_get_n_switches(); 
+
+        t_start = bench_util_get_time_ns(); 
+        for (n = 0; n < N_ROUND_TRIPS; n++)
+        {
+            si_sem_signal(&m->ping_sem); 
+            si_sem_wait(&m->pong_sem); 
+            if (m->bench_uses_fp && fegetround() != FE_UPWARD)
+            {
+                n_errors++; 
+                fesetround(FE_UPWARD); 
+            }
+        }
+        t_end = bench_util_get_time_ns(); 
+
+        printf("%-21s  %9.1f  %12ld  %6ld\n", m->mix, 
+               bench_util_ns_per_item(t_start, t_end, 2 * N_ROUND_TRIPS), 
+               fpu_get_n_switches() - n_fpu_switches, 
+               n_errors + m->n_errors); 
+    }
+
+    /* let the timer task preempt, and wake, another task */ 
+    n_fpu_switches = fpu_get_n_switches(); 
+    si_task_create(preempted_task, 
+        &Preempted_Task_Stack[STACK_SIZE-1], PREEMPTED_TASK_PRIORITY); 
+    si_task_create(timer_task, 
+        &Timer_Task_Stack[STACK_SIZE-1], TIMER_TASK_PRIORITY); 
+    si_sem_wait(&Preempt_Done_Sem); 
+    printf("%-21s  %9s  %12ld  %6ld\n", "fp/fp, preempted", "-", 
+           fpu_get_n_switches() - n_fpu_switches, 
+           N_Timer_Task_Errors + N_Preempted_Task_Errors); 
+
+    exit(0); 
+}
+
+int main(void)
+{
+    unsigned int i; 
+
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    /* create the benchmark task */ 
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], 10); 
+
+    for (i = 0; i < N_MEASUREMENTS; i++)
+    {
+        si_sem_init(&Measurement[i].ping_sem, 0); 
+        si_sem_init(&Measurement[i].pong_sem, 0); 
+    }
+    si_sem_init(&Round_Sem, 0); 
+    si_sem_init(&Preempt_Done_Sem, 0); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
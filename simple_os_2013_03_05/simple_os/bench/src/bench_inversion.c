@@ -0,0 +1,210 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_inversion: measures the response time of a high 
+   priority task, which waits for a resource held by a low 
+   priority task, while a medium priority task executes. The 
+   resource is protected first by an si_semaphore, where the 
+   medium priority task delays the high priority task 
+   (unbounded priority inversion), and then by an si_mutex, 
+   where the low priority task inherits the priority of the 
+   high priority task. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of rounds for each kind of lock */ 
+#define N_ROUNDS 5
+
+/* tick rate for the benchmark */ 
+#define TICK_RATE_HZ 1000
+
+/* execution times, in milliseconds */ 
+#define LOW_WORK_MS 20
+#define MEDIUM_WORK_MS 100
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 5000
+
+/* priorities for the tasks */ 
+#define CONTROL_PRIORITY 5
+#define HIGH_PRIORITY 10
+#define MEDIUM_PRIORITY 20
+#define LOW_PRIORITY 30
+
+static stack_item Control_Stack[STACK_SIZE]; 
+static stack_item High_Stack[STACK_SIZE]; 
+static stack_item Medium_Stack[STACK_SIZE]; 
+static stack_item Low_Stack[STACK_SIZE]; 
+
+/* the resource, protected by a semaphore or by a mutex */ 
+static si_semaphore Resource_Sem; 
+static si_mutex Resource_Mutex; 
+
+/* nonzero if Resource_Mutex is used */ 
+static int Use_Mutex; 
+
+/* semaphores for starting the tasks in each round */ 
+static si_semaphore High_Start; 
+static si_semaphore Medium_Start; 
+static si_semaphore Low_Start; 
+
+/* semaphore signalled by each task at the end of a round */ 
+static si_semaphore Round_Done; 
+
+/* the time when the high priority task was started, 
+   and when it had used the resource */ 
+static long long High_Start_Ns; 
+static long long High_End_Ns; 
+
+/* lock_resource: locks the resource */ 
+static void lock_resource(void)
+{
+    if (Use_Mutex)
+    {
+        si_mutex_lock(&Resource_Mutex); 
+    }
+    else
+    {
+        si_sem_wait(&Resource_Sem); 
+    }
+}
+
+/* unlock_resource: unlocks the resource */ 
+static void unlock_resource(void)
+{
+    if (Use_Mutex)
+    {
+        si_mutex_unlock(&Resource_Mutex); 
+    }
+    else
+    {
+        si_sem_signal(&Resource_Sem); 
+    }
+}
+
+/* high_task: uses the resource, without 
+   executing while holding it */ 
+static void high_task(void)
+{
+    while (1)
+    {
+        si_sem_wait(&High_Start); 
+        High_Start_Ns = bench_util_get_time_ns(); 
+        lock_resource(); 
+        unlock_resource(); 
+        High_End_Ns = bench_util_get_time_ns(); 
+        si_sem_signal(&Round_Done); 
+    }
+}
+
+/* medium_task: executes, without using the resource */ 
+static void medium_task(void)
+{
+    while (1)
+    {
+        si_sem_wait(&Medium_Start); 
+        bench_util_do_work_ms(MEDIUM_WORK_MS); 
+        si_sem_signal(&Round_Done); 
+    }
+}
+
+/* low_task: executes while holding the resource */ 
+static void low_task(void)
+{
+    while (1)
+    {
+        si_sem_wait(&Low_Start); 
+        lock_resource(); 
+        bench_util_do_work_ms(LOW_WORK_MS); 
+        unlock_resource(); 
+        si_sem_signal(&Round_Done); 
+    }
+}
+
+/* run_round: runs one round, and returns the response 
+   time of the high priority task, in microseconds */ 
+static long run_round(void)
+{
+    /* let the low priority task lock the resource */ 
+    si_sem_signal(&Low_Start); 
+    si_wait_n_ms(2); 
+
+    /* start the high and the medium priority task */ 
+    si_sem_signal(&High_Start); 
+    si_sem_signal(&Medium_Start); 
+
+    /* wait for all three tasks */ 
+    si_sem_wait(&Round_Done); 
+    si_sem_wait(&Round_Done); 
+    si_sem_wait(&Round_Done); 
+
+    return (long) ((High_End_Ns - High_Start_Ns) / 1000); 
+}
+
+static void control_task(void)
+{
+    int i; 
+    long response_us; 
+
+    printf("lock       round  high_response_us\n"); 
+    for (Use_Mutex = 0; Use_Mutex <= 1; Use_Mutex++)
+    {
+        for (i = 0; i < N_ROUNDS; i++)
+        {
+            response_us = run_round(); 
+            printf("%-9s  %5d  %16ld\n", 
+                   Use_Mutex ? "mutex" : "semaphore", i, response_us); 
+        }
+    }
+
+    exit(0); 
+}
+
+int main(void)
+{
+    bench_util_calibrate_work(); 
+
+    /* initialise kernel */ 
+    si_kernel_init(); 
+    si_kernel_set_tick_rate(TICK_RATE_HZ); 
+
+    si_sem_init(&Resource_Sem, 1); 
+    si_mutex_init(&Resource_Mutex); 
+    si_sem_init(&High_Start, 0); 
+    si_sem_init(&Medium_Start, 0); 
+    si_sem_init(&Low_Start, 0); 
+    si_sem_init(&Round_Done, 0); 
+
+    si_task_create(control_task, 
+        &Control_Stack[STACK_SIZE-1], CONTROL_PRIORITY); 
+    si_task_create(high_task, &High_Stack[STACK_SIZE-1], HIGH_PRIORITY); 
+    si_task_create(medium_task, 
+        &Medium_Stack[STACK_SIZE-1], MEDIUM_PRIORITY); 
+    si_task_create(low_task, &Low_Stack[STACK_SIZE-1], LOW_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
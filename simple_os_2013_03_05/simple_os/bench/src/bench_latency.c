@@ -0,0 +1,146 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_latency: measures the wakeup latency, i.e. the time 
+   from when a task becomes ready until it runs, for tasks 
+   with different priorities. Three tasks are woken by 
+   expiring waiting times, and execute for a while each time. 
+   A fourth task is woken by a semaphore, signalled by the 
+   task with highest priority. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* duration of the measurement, in milliseconds */ 
+#define RUN_MS 2000
+
+/* tick rate for the benchmark */ 
+#define TICK_RATE_HZ 1000
+
+/* waiting time and execution time for the timed tasks, 
+   in milliseconds */ 
+#define WAIT_MS 3
+#define WORK_MS 1
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 5000
+
+/* priorities for the tasks */ 
+#define CONTROL_PRIORITY 5
+#define HIGH_PRIORITY 10
+#define SIGNALLED_PRIORITY 15
+#define MEDIUM_PRIORITY 20
+#define LOW_PRIORITY 30
+
+static stack_item Control_Stack[STACK_SIZE]; 
+static stack_item High_Stack[STACK_SIZE]; 
+static stack_item Signalled_Stack[STACK_SIZE]; 
+static stack_item Medium_Stack[STACK_SIZE]; 
+static stack_item Low_Stack[STACK_SIZE]; 
+
+/* semaphore signalled by the high priority task */ 
+static si_semaphore Signal_Sem; 
+
+/* task ids, and names */ 
+#define N_TASKS 4
+static int Task_Id[N_TASKS]; 
+static char *Task_Name[N_TASKS] = 
+    {"high", "signalled", "medium", "low"}; 
+
+/* timed_task: waits, and then executes */ 
+static void timed_task(void)
+{
+    while (1)
+    {
+        si_wait_n_ms(WAIT_MS); 
+        bench_util_do_work_ms(WORK_MS); 
+    }
+}
+
+/* high_task: waits, and then signals Signal_Sem */ 
+static void high_task(void)
+{
+    while (1)
+    {
+        si_wait_n_ms(WAIT_MS); 
+        si_sem_signal(&Signal_Sem); 
+    }
+}
+
+/* signalled_task: waits for Signal_Sem, and then executes */ 
+static void signalled_task(void)
+{
+    while (1)
+    {
+        si_sem_wait(&Signal_Sem); 
+        bench_util_do_work_ms(WORK_MS); 
+    }
+}
+
+static void control_task(void)
+{
+    /* the wakeup latency for a task */ 
+    si_latency_stats stats; 
+
+    int i; 
+
+    si_wait_n_ms(RUN_MS); 
+
+    printf("task       samples  mean_us  p50_us  p90_us  p99_us  max_us\n"); 
+    for (i = 0; i < N_TASKS; i++)
+    {
+        si_task_get_latency_stats(Task_Id[i], &stats); 
+        printf("%-9s  %7d  %7ld  %6ld  %6ld  %6ld  %6ld\n", 
+               Task_Name[i], stats.n_samples, stats.mean_us, 
+               stats.p50_us, stats.p90_us, stats.p99_us, stats.max_us); 
+    }
+
+    exit(0); 
+}
+
+int main(void)
+{
+    bench_util_calibrate_work(); 
+
+    /* initialise kernel */ 
+    si_kernel_init(); 
+    si_kernel_set_tick_rate(TICK_RATE_HZ); 
+
+    si_sem_init(&Signal_Sem, 0); 
+
+    si_task_create(control_task, 
+        &Control_Stack[STACK_SIZE-1], CONTROL_PRIORITY); 
+    Task_Id[0] = si_task_create(high_task, 
+        &High_Stack[STACK_SIZE-1], HIGH_PRIORITY); 
+    Task_Id[1] = si_task_create(signalled_task, 
+        &Signalled_Stack[STACK_SIZE-1], SIGNALLED_PRIORITY); 
+    Task_Id[2] = si_task_create(timed_task, 
+        &Medium_Stack[STACK_SIZE-1], MEDIUM_PRIORITY); 
+    Task_Id[3] = si_task_create(timed_task, 
+        &Low_Stack[STACK_SIZE-1], LOW_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
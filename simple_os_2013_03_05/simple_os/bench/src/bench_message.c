@@ -0,0 +1,313 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_message: measures the round-trip time for a message 
+   sent to a server task, which sends it back, when the message 
+   is copied, using si_message_send and si_message_receive, and 
+   when a block is passed without copying, using 
+   si_message_send_block and si_message_receive_block, and when 
+   the server receives a request, and replies, using 
+   si_message_send_receive, si_message_receive_request and 
+   si_message_reply. The time 
+   for sending a burst of messages to a task with lower priority 
+   is measured for the default mailbox depth, where the sending 
+   task waits when the mailbox is full, and for a mailbox with 
+   room for the whole burst. The time from sending an urgent 
+   message, last in a burst, until it is received, and the number 
+   of messages received before it, are measured when the urgent 
+   message is sent with the default priority, and with the most 
+   urgent priority, using si_message_send_prio. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of round trips in each measurement */ 
+#define N_ROUND_TRIPS 100000
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 10000
+
+/* number of messages in a burst */ 
+#define BURST_SIZE 16
+
+/* priorities for the tasks */ 
+#define SERVER_PRIORITY 10
+#define BENCH_PRIORITY 20
+#define CONSUMER_PRIORITY 30
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+static stack_item Server_Stack[STACK_SIZE]; 
+static stack_item Call_Server_Stack[STACK_SIZE]; 
+static stack_item Consumer_Stack[STACK_SIZE]; 
+
+/* the task id of the server */ 
+static int Server_Task_Id; 
+
+/* the task id of the server which replies to requests */ 
+static int Call_Server_Task_Id; 
+
+/* the task id of the consumer */ 
+static int Consumer_Task_Id; 
+
+/* semaphore signalled by the consumer when a burst is received */ 
+static si_semaphore Burst_Done; 
+
+/* the time when the consumer received the urgent message, 
+   and the sum of the number of messages received before it */ 
+static long long Urgent_Receive_ns; 
+static long Urgent_Position_Sum; 
+
+/* nonzero when blocks are passed without copying */ 
+static int Use_Blocks; 
+
+/* server_task: sends each message back to its sender */ 
+static void server_task(void)
+{
+    char message[MESSAGE_LENGTH]; 
+    void *block; 
+    int length; 
+    int send_task_id; 
+
+    while (1)
+    {
+        if (Use_Blocks)
+        {
+            block = si_message_receive_block(&length, &send_task_id); 
+            si_message_send_block(block, length, send_task_id); 
+        }
+        else
+        {
+            si_message_receive(message, &length, &send_task_id); 
+            si_message_send(message, length, send_task_id); 
+        }
+    }
+}
+
+/* call_server_task: replies to each request with its contents */ 
+static void call_server_task(void)
+{
+    char request[SI_MESSAGE_BLOCK_SIZE]; 
+    int length; 
+    int call_task_id; 
+
+    while (1)
+    {
+        call_task_id = si_message_receive_request(
+            request, SI_MESSAGE_BLOCK_SIZE, &length); 
+        si_message_reply(call_task_id, request, length); 
+    }
+}
+
+/* consumer_task: receives bursts of messages */ 
+static void consumer_task(void)
+{
+    char message[MESSAGE_LENGTH]; 
+    int length; 
+    int send_task_id; 
+    int i; 
+
+    while (1)
+    {
+        for (i = 0; i < BURST_SIZE; i++)
+        {
+            si_message_receive(message, &length, &send_task_id); 
+            if (message[0] == 'U')
+            {
+                Urgent_Receive_ns = bench_util_get_time_ns(); 
+                Urgent_Position_Sum += i; 
+            }
+        }
+        si_sem_signal(&Burst_Done); 
+    }
+}
+
+/* measure_burst: returns the time, in ns, for sending a 
+   message in a burst to the consumer, which has a mailbox 
+   with room for depth messages */ 
+static double measure_burst(int depth)
+{
+    char message[MESSAGE_LENGTH]; 
+    long long t_send_ns; 
+    long long t_start; 
+    long n; 
+    int i; 
+
+    si_message_set_depth(Consumer_Task_Id, depth); 
+    t_send_ns = 0; 
+    for (n = 0; n < N_ROUND_TRIPS; n += BURST_SIZE)
+    {
+        t_start = bench_util_get_time_ns(); 
+        for (i = 0; i < BURST_SIZE; i++)
+        {
+            si_message_send(message, 16, Consumer_Task_Id); 
+        }
+        t_send_ns += bench_util_get_time_ns() - t_start; 
+        si_sem_wait(&Burst_Done); 
+    }
+    return bench_util_ns_per_item(0, t_send_ns, N_ROUND_TRIPS); 
+}
+
+/* measure_urgent: sends bursts to the consumer, with room for 
+   the whole burst, where the last message is urgent and sent 
+   with priority. Returns the time, in ns, from sending the urgent 
+   message until it is received, and sets *position to the mean 
+   number of messages received before it. */ 
+static double measure_urgent(int priority, double *position)
+{
+    char message[MESSAGE_LENGTH]; 
+    long long t_urgent_ns; 
+    long long t_start; 
+    long n; 
+    int i; 
+
+    si_message_set_depth(Consumer_Task_Id, BURST_SIZE); 
+    t_urgent_ns = 0; 
+    Urgent_Position_Sum = 0; 
+    for (n = 0; n < N_ROUND_TRIPS; n += BURST_SIZE)
+    {
+        message[0] = 'D'; 
+        for (i = 0; i < BURST_SIZE - 1; i++)
+        {
+            si_message_send(message, 16, Consumer_Task_Id); 
+        }
+        message[0] = 'U'; 
+        t_start = bench_util_get_time_ns(); 
+        si_message_send_prio(message, 16, Consumer_Task_Id, priority); 
+        si_sem_wait(&Burst_Done); 
+        t_urgent_ns += Urgent_Receive_ns - t_start; 
+    }
+    *position = (double) Urgent_Position_Sum / (N_ROUND_TRIPS / BURST_SIZE); 
+    return bench_util_ns_per_item(0, t_urgent_ns, N_ROUND_TRIPS / BURST_SIZE); 
+}
+
+/* measure_copy: returns the round-trip time, in ns, 
+   for copied messages of length bytes */ 
+static double measure_copy(int length)
+{
+    char message[MESSAGE_LENGTH]; 
+    int send_task_id; 
+    long long t_start, t_end; 
+    long n; 
+
+    Use_Blocks = 0; 
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_ROUND_TRIPS; n++)
+    {
+        si_message_send(message, length, Server_Task_Id); 
+        si_message_receive(message, &length, &send_task_id); 
+    }
+    t_end = bench_util_get_time_ns(); 
+    return bench_util_ns_per_item(t_start, t_end, N_ROUND_TRIPS); 
+}
+
+/* measure_block: returns the round-trip time, in ns, for 
+   messages of length bytes passed without copying, 
+   including allocation and free of the block */ 
+static double measure_block(int length)
+{
+    void *block; 
+    int send_task_id; 
+    long long t_start, t_end; 
+    long n; 
+
+    Use_Blocks = 1; 
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_ROUND_TRIPS; n++)
+    {
+        block = si_message_alloc(); 
+        si_message_send_block(block, length, Server_Task_Id); 
+        block = si_message_receive_block(&length, &send_task_id); 
+        si_message_free(block); 
+    }
+    t_end = bench_util_get_time_ns(); 
+    return bench_util_ns_per_item(t_start, t_end, N_ROUND_TRIPS); 
+}
+
+/* measure_call: returns the round-trip time, in ns, for 
+   requests and replies of length bytes */ 
+static double measure_call(int length)
+{
+    static char request[SI_MESSAGE_BLOCK_SIZE]; 
+    static char reply[SI_MESSAGE_BLOCK_SIZE]; 
+    long long t_start, t_end; 
+    long n; 
+
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_ROUND_TRIPS; n++)
+    {
+        si_message_send_receive(Call_Server_Task_Id, request, length, 
+                                reply, SI_MESSAGE_BLOCK_SIZE); 
+    }
+    t_end = bench_util_get_time_ns(); 
+    return bench_util_ns_per_item(t_start, t_end, N_ROUND_TRIPS); 
+}
+
+static void bench_task(void)
+{
+    double t_urgent; 
+    double position; 
+
+    printf("length  copy_ns  block_ns  call_ns\n"); 
+    printf("%6d  %7.1f  %8.1f  %7.1f\n", 16, 
+           measure_copy(16), measure_block(16), measure_call(16)); 
+    printf("%6d  %7.1f  %8.1f  %7.1f\n", MESSAGE_LENGTH, 
+           measure_copy(MESSAGE_LENGTH), measure_block(MESSAGE_LENGTH), 
+           measure_call(MESSAGE_LENGTH)); 
+    printf("%6d  %7s  %8.1f  %7.1f\n", SI_MESSAGE_BLOCK_SIZE, "-", 
+           measure_block(SI_MESSAGE_BLOCK_SIZE), 
+           measure_call(SI_MESSAGE_BLOCK_SIZE)); 
+    printf("depth  burst_send_ns\n"); 
+    printf("%5d  %13.1f\n", SI_MESSAGE_DEFAULT_DEPTH, 
+           measure_burst(SI_MESSAGE_DEFAULT_DEPTH)); 
+    printf("%5d  %13.1f\n", BURST_SIZE, measure_burst(BURST_SIZE)); 
+    printf("priority  urgent_ns  received_before\n"); 
+    t_urgent = measure_urgent(SI_MESSAGE_DEFAULT_PRIORITY, &position); 
+    printf("%8d  %9.1f  %15.1f\n", 
+           SI_MESSAGE_DEFAULT_PRIORITY, t_urgent, position); 
+    t_urgent = measure_urgent(0, &position); 
+    printf("%8d  %9.1f  %15.1f\n", 0, t_urgent, position); 
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    si_message_init(); 
+    si_sem_init(&Burst_Done, 0); 
+
+    Server_Task_Id = si_task_create(server_task, 
+        &Server_Stack[STACK_SIZE-1], SERVER_PRIORITY); 
+    Call_Server_Task_Id = si_task_create(call_server_task, 
+        &Call_Server_Stack[STACK_SIZE-1], SERVER_PRIORITY); 
+    Consumer_Task_Id = si_task_create(consumer_task, 
+        &Consumer_Stack[STACK_SIZE-1], CONSUMER_PRIORITY); 
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], BENCH_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
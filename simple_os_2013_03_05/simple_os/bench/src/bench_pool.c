@@ -0,0 +1,178 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_pool: measures the cost of allocating and freeing 
+   a block from an si_pool, compared with malloc and free, 
+   for single allocations, and for a batch of allocations 
+   freed in a different order. A second task, waiting in 
+   si_pool_alloc for an empty pool, checks that freed 
+   blocks are handed over. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of allocations in each measurement */ 
+#define N_CALLS 1000000
+
+/* block size, and number of blocks in the pool */ 
+#define BLOCK_SIZE 64
+#define N_BLOCKS 64
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 10000
+
+/* priorities for the tasks */ 
+#define WAITER_PRIORITY 10
+#define BENCH_PRIORITY 20
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+static stack_item Waiter_Stack[STACK_SIZE]; 
+
+static si_pool_item Pool_Memory[SI_POOL_N_ITEMS(BLOCK_SIZE, N_BLOCKS)]; 
+static si_pool Pool; 
+
+/* the blocks in a batch */ 
+static void *Block[N_BLOCKS]; 
+
+/* number of blocks received by the waiting task */ 
+static int N_Received; 
+
+/* pool_alloc and pool_free: allocation and free 
+   using Pool, in the form of malloc and free */ 
+static void *pool_alloc(size_t size)
+{
+    return si_pool_alloc(&Pool); 
+}
+
+static void pool_free(void *block)
+{
+    si_pool_free(&Pool, block); 
+}
+
+/* measure_single: returns the time for an 
+   allocation and a free, in ns */ 
+static double measure_single(
+    void *(*alloc_function)(size_t), void (*free_function)(void *))
+{
+    long long t_start, t_end; 
+    long n; 
+
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_CALLS; n++)
+    {
+        free_function(alloc_function(BLOCK_SIZE)); 
+    }
+    t_end = bench_util_get_time_ns(); 
+    return bench_util_ns_per_item(t_start, t_end, N_CALLS); 
+}
+
+/* measure_batch: returns the time for an allocation and a 
+   free, in ns, when N_BLOCKS blocks are allocated, and then 
+   freed with every other block first */ 
+static double measure_batch(
+    void *(*alloc_function)(size_t), void (*free_function)(void *))
+{
+    long long t_start, t_end; 
+    long n; 
+    int i; 
+
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_CALLS; n += N_BLOCKS)
+    {
+        for (i = 0; i < N_BLOCKS; i++)
+        {
+            Block[i] = alloc_function(BLOCK_SIZE); 
+        }
+        for (i = 0; i < N_BLOCKS; i += 2)
+        {
+            free_function(Block[i]); 
+        }
+        for (i = 1; i < N_BLOCKS; i += 2)
+        {
+            free_function(Block[i]); 
+        }
+    }
+    t_end = bench_util_get_time_ns(); 
+    return bench_util_ns_per_item(t_start, t_end, N_CALLS); 
+}
+
+/* waiter_task: allocates from the empty pool, 
+   and keeps each block it gets */ 
+static void waiter_task(void)
+{
+    while (1)
+    {
+        si_pool_alloc(&Pool); 
+        N_Received++; 
+    }
+}
+
+static void bench_task(void)
+{
+    si_pool_stats stats; 
+    int i; 
+
+    printf("allocator  single_ns  batch_ns\n"); 
+    printf("si_pool    %9.1f  %8.1f\n", 
+           measure_single(pool_alloc, pool_free), 
+           measure_batch(pool_alloc, pool_free)); 
+    printf("malloc     %9.1f  %8.1f\n", 
+           measure_single(malloc, free), 
+           measure_batch(malloc, free)); 
+
+    /* empty the pool, and let the waiting task wait */ 
+    for (i = 0; i < N_BLOCKS; i++)
+    {
+        Block[i] = si_pool_alloc(&Pool); 
+    }
+    si_task_create(waiter_task, 
+        &Waiter_Stack[STACK_SIZE-1], WAITER_PRIORITY); 
+    /* each free wakes the waiting task, which gets the block */ 
+    for (i = 0; i < N_BLOCKS; i++)
+    {
+        si_pool_free(&Pool, Block[i]); 
+    }
+
+    si_pool_get_stats(&Pool, &stats); 
+    printf("blocks received by waiting task: %d\n", N_Received); 
+    printf("block_size %d n_blocks %d n_free %d max_used %d waits %ld\n", 
+           stats.block_size, stats.n_blocks, stats.n_free, 
+           stats.max_used, stats.n_waits); 
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    si_pool_init(&Pool, Pool_Memory, BLOCK_SIZE, N_BLOCKS); 
+
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], BENCH_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
@@ -0,0 +1,140 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+/* bench_schedule: measures the cost of schedule(), and of 
+   inserting and removing a task in the ready list, for an 
+   increasing number of ready tasks. The cost shall not 
+   depend on the number of ready tasks. */ 
+
+#include "simple_os.h"
+
+#include "schedule.h"
+#include "ready_list.h"
+#include "task.h"
+#include "interrupt.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of calls in each measurement */ 
+#define N_CALLS 1000000
+
+/* stack size for the benchmark task */ 
+#define BENCH_STACK_SIZE 10000
+
+/* stack size for the ready tasks, which never run */ 
+#define READY_STACK_SIZE 64
+
+/* number of ready tasks for each measurement, including 
+   the benchmark task and the idle task */ 
+static const int N_Ready_Tasks[] = {20, 100, 500, 1000, 2000, 4000}; 
+
+#define N_MEASUREMENTS (sizeof(N_Ready_Tasks) / sizeof(N_Ready_Tasks[0]))
+
+static stack_item Bench_Stack[BENCH_STACK_SIZE]; 
+
+static stack_item Ready_Stack[TCB_LIST_SIZE][READY_STACK_SIZE]; 
+
+/* ready_task: a task which is ready to run, but never 
+   runs, since the benchmark task has higher priority */ 
+static void ready_task(void)
+{
+    while (1)
+    {
+        si_wait_n_ms(1000); 
+    }
+}
+
+static void bench_task(void)
+{
+    /* number of ready tasks, initially the 
+       benchmark task and the idle task */ 
+    int n_ready = 2; 
+    /* task id of the benchmark task */ 
+    int task_id = task_get_task_id_running(); 
+    /* time stamps */ 
+    long long t_start, t_end; 
+    /* measured times per call */ 
+    double schedule_ns, insert_remove_ns; 
+
+    unsigned int i; 
+    long n; 
+
+    printf("n_ready_tasks  schedule_ns  remove_insert_ns\n"); 
+
+    for (i = 0; i < N_MEASUREMENTS; i++)
+    {
+        /* create ready tasks, with priorities spread 
+           over the priority levels */ 
+        while (n_ready < N_Ready_Tasks[i])
+        {
+            si_task_create(ready_task, 
+                &Ready_Stack[n_ready][READY_STACK_SIZE-1], 
+                1 + n_ready % (IDLE_PRIORITY - 1)); 
+            n_ready++; 
+        }
+
+        DISABLE_INTERRUPTS; 
+
+        /* schedule, without task switch, since the 
+           benchmark task has the highest priority */ 
+        t_start = bench_util_get_time_ns(); 
+        for (n = 0; n < N_CALLS; n++)
+        {
+            schedule(); 
+        }
+        t_end = bench_util_get_time_ns(); 
+        schedule_ns = bench_util_ns_per_item(t_start, t_end, N_CALLS); 
+
+        /* remove and insert the benchmark task */ 
+        t_start = bench_util_get_time_ns(); 
+        for (n = 0; n < N_CALLS; n++)
+        {
+            ready_list_remove(task_id); 
+            ready_list_insert(task_id); 
+        }
+        t_end = bench_util_get_time_ns(); 
+        insert_remove_ns = bench_util_ns_per_item(t_start, t_end, N_CALLS); 
+
+        ENABLE_INTERRUPTS; 
+
+        printf("%13d  %11.1f  %16.1f\n", 
+               n_ready, schedule_ns, insert_remove_ns); 
+    }
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    /* create the benchmark task, with highest priority */ 
+    si_task_create(bench_task, &Bench_Stack[BENCH_STACK_SIZE-1], 0); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
@@ -0,0 +1,131 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_slice: runs N_WORKERS compute-bound tasks with equal 
+   priority, without a time quantum and with different time 
+   quanta, set by si_kernel_set_time_slice, and reports the 
+   share of the CPU time and the number of preemptions for 
+   each task, using si_task_get_stats. Without a quantum, 
+   one task is expected to get all CPU time. */ 
+
+#include "simple_os.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 10000
+
+/* number of compute-bound tasks */ 
+#define N_WORKERS 4
+
+/* the time, in ms, for each quantum */ 
+#define RUN_MS 1000
+
+/* number of ticks per second, so that short 
+   quanta can be used */ 
+#define TICKS_PER_SEC 1000
+
+/* the time quanta, in ms, where 0 means no quantum */ 
+#define N_QUANTA 4
+static const int Quanta[N_QUANTA] = {0, 1, 10, 100}; 
+
+/* priorities for the tasks, where the benchmark task 
+   has the highest priority, so that it can take the 
+   measurements while the workers compute */ 
+#define BENCH_PRIORITY 5
+#define WORKER_PRIORITY 10
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+static stack_item Worker_Stack[N_WORKERS][STACK_SIZE]; 
+
+/* task ids for the workers */ 
+static int Worker_Task_Id[N_WORKERS]; 
+
+/* worker_task: computes for ever */ 
+static void worker_task(void)
+{
+    volatile long count = 0; 
+
+    while (1)
+    {
+        count++; 
+    }
+}
+
+static void bench_task(void)
+{
+    /* statistics for the workers, at the start of a quantum */ 
+    si_task_stats start_stats[N_WORKERS]; 
+    si_task_stats stats; 
+    si_kernel_stats kernel_start_stats; 
+    si_kernel_stats kernel_stats; 
+    long long elapsed_us; 
+    int q; 
+    int i; 
+
+    printf("quantum_ms  task  share_percent  n_preempted\n"); 
+    for (q = 0; q < N_QUANTA; q++)
+    {
+        si_kernel_set_time_slice(WORKER_PRIORITY, Quanta[q]); 
+        si_kernel_get_stats(&kernel_start_stats); 
+        for (i = 0; i < N_WORKERS; i++)
+        {
+            si_task_get_stats(Worker_Task_Id[i], &start_stats[i]); 
+        }
+
+        /* let the workers compute */ 
+        si_wait_n_ms(RUN_MS); 
+
+        si_kernel_get_stats(&kernel_stats); 
+        elapsed_us = kernel_stats.elapsed_us - kernel_start_stats.elapsed_us; 
+        for (i = 0; i < N_WORKERS; i++)
+        {
+            si_task_get_stats(Worker_Task_Id[i], &stats); 
+            printf("%10d  %4d  %13.1f  %11d\n", Quanta[q], i, 
+                   100.0 * (stats.run_time_us - start_stats[i].run_time_us) / 
+                   elapsed_us, 
+                   stats.n_preempted - start_stats[i].n_preempted); 
+        }
+    }
+
+    exit(0); 
+}
+
+int main(void)
+{
+    int i; 
+
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    si_kernel_set_tick_rate(TICKS_PER_SEC); 
+
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], BENCH_PRIORITY); 
+    for (i = 0; i < N_WORKERS; i++)
+    {
+        Worker_Task_Id[i] = si_task_create(
+            worker_task, &Worker_Stack[i][STACK_SIZE-1], WORKER_PRIORITY); 
+    }
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
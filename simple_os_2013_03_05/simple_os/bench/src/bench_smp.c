@@ -0,0 +1,136 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_smp: measures the time for a number of worker 
+   tasks, with the same priority, to execute a fixed amount 
+   of work each. With SMP_HOST, the workers are distributed 
+   over the CPUs, and the speedup relative to executing the 
+   work on one CPU is printed. The speedup is limited by the 
+   number of cores on the host. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+#include "smp.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of rounds */ 
+#define N_ROUNDS 3
+
+/* number of worker tasks */ 
+#define N_WORKERS 8
+
+/* execution time for each worker, in milliseconds */ 
+#define WORK_MS 100
+
+/* tick rate for the benchmark */ 
+#define TICK_RATE_HZ 1000
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 5000
+
+/* priorities for the tasks */ 
+#define CONTROL_PRIORITY 5
+#define WORKER_PRIORITY 10
+
+static stack_item Control_Stack[STACK_SIZE]; 
+static stack_item Worker_Stack[N_WORKERS][STACK_SIZE]; 
+
+/* semaphore for starting the workers in each round */ 
+static si_semaphore Work_Start; 
+
+/* semaphore signalled by each worker at the end of a round */ 
+static si_semaphore Work_Done; 
+
+/* worker_task: executes WORK_MS milliseconds in each round */ 
+static void worker_task(void)
+{
+    while (1)
+    {
+        si_sem_wait(&Work_Start); 
+        bench_util_do_work_ms(WORK_MS); 
+        si_sem_signal(&Work_Done); 
+    }
+}
+
+/* run_round: runs one round, and returns the 
+   elapsed time, in milliseconds */ 
+static double run_round(void)
+{
+    /* the time when the round started */ 
+    long long start_ns; 
+    int i; 
+
+    start_ns = bench_util_get_time_ns(); 
+    for (i = 0; i < N_WORKERS; i++)
+    {
+        si_sem_signal(&Work_Start); 
+    }
+    for (i = 0; i < N_WORKERS; i++)
+    {
+        si_sem_wait(&Work_Done); 
+    }
+    return (bench_util_get_time_ns() - start_ns) / 1e6; 
+}
+
+static void control_task(void)
+{
+    int i; 
+    double elapsed_ms; 
+
+    printf("cpus  workers  work_ms  round  elapsed_ms  speedup\n"); 
+    for (i = 0; i < N_ROUNDS; i++)
+    {
+        elapsed_ms = run_round(); 
+        printf("%4d  %7d  %7d  %5d  %10.1f  %7.2f\n", 
+               SMP_N_CPUS, N_WORKERS, WORK_MS, i, elapsed_ms, 
+               N_WORKERS * WORK_MS / elapsed_ms); 
+    }
+
+    exit(0); 
+}
+
+int main(void)
+{
+    int i; 
+
+    bench_util_calibrate_work(); 
+
+    /* initialise kernel */ 
+    si_kernel_init(); 
+    si_kernel_set_tick_rate(TICK_RATE_HZ); 
+
+    si_sem_init(&Work_Start, 0); 
+    si_sem_init(&Work_Done, 0); 
+
+    si_task_create(control_task, 
+        &Control_Stack[STACK_SIZE-1], CONTROL_PRIORITY); 
+    for (i = 0; i < N_WORKERS; i++)
+    {
+        si_task_create(worker_task, 
+            &Worker_Stack[i][STACK_SIZE-1], WORKER_PRIORITY); 
+    }
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
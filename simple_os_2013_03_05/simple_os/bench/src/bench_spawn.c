@@ -0,0 +1,128 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_spawn: measures the cost of creating a short-lived task 
+   with si_task_create_auto, letting it run and return, so that 
+   it exits, and checks that task ids and stacks are reused. A 
+   task waiting for a semaphore is also deleted, using 
+   si_task_delete. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of tasks created */ 
+#define N_SPAWN 100000
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 10000
+#define SPAWN_STACK_SIZE 1000
+
+/* priorities for the tasks */ 
+#define SPAWN_PRIORITY 10
+#define BENCH_PRIORITY 20
+#define WAITER_PRIORITY 30
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+
+/* number of runs of the short-lived task */ 
+static int N_Runs; 
+
+/* semaphore where a task waits until it is deleted */ 
+static si_semaphore Sem; 
+
+/* number of tasks passing Sem */ 
+static int N_Passed; 
+
+/* spawn_task: a short-lived task, which returns, and thus exits */ 
+static void spawn_task(void)
+{
+    N_Runs++; 
+}
+
+/* waiter_task: waits for Sem, and is deleted while waiting */ 
+static void waiter_task(void)
+{
+    si_sem_wait(&Sem); 
+    N_Passed++; 
+}
+
+static void bench_task(void)
+{
+    long long t_start, t_end; 
+    int task_id; 
+    int max_task_id; 
+    int waiter_id; 
+    int result; 
+    long n; 
+
+    max_task_id = 0; 
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_SPAWN; n++)
+    {
+        /* the task has higher priority, and runs to its end */ 
+        task_id = si_task_create_auto(
+            spawn_task, SPAWN_STACK_SIZE, SPAWN_PRIORITY); 
+        if (task_id > max_task_id)
+        {
+            max_task_id = task_id; 
+        }
+    }
+    t_end = bench_util_get_time_ns(); 
+
+    printf("spawn_ns  %.1f\n", bench_util_ns_per_item(t_start, t_end, N_SPAWN)); 
+    printf("tasks run: %d of %d, largest task id: %d\n", 
+           N_Runs, N_SPAWN, max_task_id); 
+
+    /* delete a task while it waits for Sem */ 
+    waiter_id = si_task_create_auto(
+        waiter_task, SPAWN_STACK_SIZE, WAITER_PRIORITY); 
+    /* let the waiting task run */ 
+    si_wait_n_ms(10); 
+    result = si_task_delete(waiter_id); 
+    /* a second delete of the same task fails */ 
+    printf("delete waiting task: %d, again: %d\n", 
+           result, si_task_delete(waiter_id)); 
+    /* no task waits for Sem, so the counter is incremented */ 
+    si_sem_signal(&Sem); 
+    si_wait_n_ms(10); 
+    printf("tasks passed semaphore: %d\n", N_Passed); 
+    printf("reused task id: %d\n", si_task_create_auto(
+        spawn_task, SPAWN_STACK_SIZE, SPAWN_PRIORITY) == waiter_id); 
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    si_sem_init(&Sem, 0); 
+
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], BENCH_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
@@ -0,0 +1,180 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_stack: reports the largest stack usage, as returned by 
+   si_task_get_stack_stats, for tasks created with 
+   si_task_create_stack, which use their stacks to different 
+   depths. When started with the argument overflow, a task 
+   overflows its stack, and the canary check stops the program, 
+   with exit status 1. */ 
+
+#include "simple_os.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* stack size for the benchmark task and the measured tasks */ 
+#define STACK_SIZE 10000
+
+/* stack size for the task which overflows its stack */ 
+#define SMALL_STACK_SIZE 1000
+
+/* number of stack items below the small stack, which are 
+   overwritten, instead of other data, when it overflows */ 
+#define GUARD_SIZE 10000
+
+/* number of bytes used by each level of recursion */ 
+#define FRAME_BYTES 256
+
+/* recursion depth for the task which overflows its stack */ 
+#define OVERFLOW_DEPTH 100
+
+/* number of measured tasks, and their recursion depths */ 
+#define N_DEPTHS 4
+static const int Depths[N_DEPTHS] = {0, 10, 50, 100}; 
+
+/* priorities for the tasks */ 
+#define MEASURED_PRIORITY 10
+#define BENCH_PRIORITY 20
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+
+/* the stacks for the measured tasks */ 
+static stack_item Measured_Stack[N_DEPTHS][STACK_SIZE]; 
+
+/* the stack for the task which overflows its stack, 
+   preceded by a guard area */ 
+static struct
+{
+    stack_item guard[GUARD_SIZE]; 
+    stack_item stack[SMALL_STACK_SIZE]; 
+} Small_Stack; 
+
+/* the recursion depth for the next created task */ 
+static int Depth; 
+
+/* signalled by a measured task when it has used its stack */ 
+static si_semaphore Done_Sem; 
+
+/* never signalled, a measured task waits here until deleted */ 
+static si_semaphore Stop_Sem; 
+
+/* use_stack: recurses depth levels, using FRAME_BYTES of the 
+   stack for each level, and waits at the deepest level, so 
+   that the stack is checked */ 
+static int use_stack(int depth)
+{
+    volatile char buffer[FRAME_BYTES]; 
+
+    buffer[0] = (char) depth; 
+    buffer[FRAME_BYTES-1] = (char) depth; 
+    if (depth > 0)
+    {
+        return use_stack(depth - 1) + buffer[FRAME_BYTES-1]; 
+    }
+    /* the task stops running, and its stack is checked */ 
+    si_wait_n_ms(10); 
+    return buffer[0]; 
+}
+
+/* measured_task: uses its stack to the depth Depth */ 
+static void measured_task(void)
+{
+    use_stack(Depth); 
+    si_sem_signal(&Done_Sem); 
+    si_sem_wait(&Stop_Sem); 
+}
+
+/* overflow_task: uses more than its stack */ 
+static void overflow_task(void)
+{
+    printf("overflow  task %d uses %d bytes of a stack of %d items\n", 
+           si_task_get_id(), OVERFLOW_DEPTH * FRAME_BYTES, SMALL_STACK_SIZE); 
+    fflush(stdout); 
+    use_stack(OVERFLOW_DEPTH); 
+    /* not reached, since the canary check stops the program */ 
+    printf("overflow  not detected\n"); 
+    exit(0); 
+}
+
+/* print_stack_stats: prints the stack usage of task_id */ 
+static void print_stack_stats(const char *name, int depth, int task_id)
+{
+    si_stack_stats stats; 
+
+    if (si_task_get_stack_stats(task_id, &stats) != 0)
+    {
+        printf("%-8s  no stack statistics\n", name); 
+        return; 
+    }
+    printf("%-8s  %5d  %10d  %8d\n", 
+           name, depth, stats.stack_size, stats.max_used); 
+}
+
+static void bench_task(void)
+{
+    int task_id; 
+    int i; 
+
+    printf("task      depth  stack_size  max_used\n"); 
+    for (i = 0; i < N_DEPTHS; i++)
+    {
+        Depth = Depths[i]; 
+        task_id = si_task_create_stack(
+            measured_task, Measured_Stack[i], STACK_SIZE, MEASURED_PRIORITY); 
+        si_sem_wait(&Done_Sem); 
+        print_stack_stats("measured", Depth, task_id); 
+        si_task_delete(task_id); 
+    }
+    print_stack_stats("bench", 0, si_task_get_id()); 
+
+    exit(0); 
+}
+
+/* bench_overflow_task: starts the task which overflows its stack */ 
+static void bench_overflow_task(void)
+{
+    si_task_create_stack(overflow_task, Small_Stack.stack, 
+                         SMALL_STACK_SIZE, MEASURED_PRIORITY); 
+    /* the program is stopped when overflow_task stops running */ 
+    si_wait_n_ms(1000); 
+    printf("overflow  not detected\n"); 
+    exit(0); 
+}
+
+int main(int argc, char *argv[])
+{
+    /* run the overflow case, if requested */ 
+    int overflow = argc > 1 && strcmp(argv[1], "overflow") == 0; 
+
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    si_sem_init(&Done_Sem, 0); 
+    si_sem_init(&Stop_Sem, 0); 
+
+    si_task_create_stack(overflow ? bench_overflow_task : bench_task, 
+                         Bench_Stack, STACK_SIZE, BENCH_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
@@ -0,0 +1,142 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_switch: measures the cost of a task switch, first 
+   as a bare call to context_switch between two stacks, and 
+   then as a kernel task switch, where two tasks signal each 
+   other using semaphores. Build the benchmark for x86_host 
+   and x86_64_host to compare the 32-bit and 64-bit context 
+   switch. */ 
+
+#include "simple_os.h"
+
+#include "context.h"
+#include "tcb.h"
+#include "tcb_storage.h"
+#include "ready_list.h"
+#include "interrupt.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of round trips in each measurement, 
+   with two task switches per round trip */ 
+#define N_ROUND_TRIPS 1000000
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 5000
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+static stack_item Partner_Stack[STACK_SIZE]; 
+static stack_item Pong_Stack[STACK_SIZE]; 
+
+/* saved stack pointers for the bare context switch */ 
+static mem_address Bench_Sp; 
+static mem_address Partner_Sp; 
+
+/* semaphores for the kernel task switch */ 
+static si_semaphore Ping_Sem; 
+static si_semaphore Pong_Sem; 
+
+/* partner_task: switches back to the benchmark task, 
+   without the kernel. The task is not in the ready list, 
+   and is started by the first call to context_switch. */ 
+static void partner_task(void)
+{
+    DISABLE_INTERRUPTS; 
+    while (1)
+    {
+        context_switch(&Partner_Sp, Bench_Sp); 
+    }
+}
+
+/* pong_task: answers each signal on Ping_Sem 
+   with a signal on Pong_Sem */ 
+static void pong_task(void)
+{
+    while (1)
+    {
+        si_sem_wait(&Ping_Sem); 
+        si_sem_signal(&Pong_Sem); 
+    }
+}
+
+static void bench_task(void)
+{
+    /* time stamps */ 
+    long long t_start, t_end; 
+    long n; 
+
+    printf("switch   switch_ns\n"); 
+
+    /* bare context switch, with interrupts disabled, 
+       and no timer interrupts in tickless mode */ 
+    DISABLE_INTERRUPTS; 
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_ROUND_TRIPS; n++)
+    {
+        context_switch(&Bench_Sp, Partner_Sp); 
+    }
+    t_end = bench_util_get_time_ns(); 
+    ENABLE_INTERRUPTS; 
+    printf("context  %9.1f\n", 
+           bench_util_ns_per_item(t_start, t_end, 2 * N_ROUND_TRIPS)); 
+
+    /* kernel task switch, including the semaphore operations */ 
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_ROUND_TRIPS; n++)
+    {
+        si_sem_signal(&Ping_Sem); 
+        si_sem_wait(&Pong_Sem); 
+    }
+    t_end = bench_util_get_time_ns(); 
+    printf("kernel   %9.1f\n", 
+           bench_util_ns_per_item(t_start, t_end, 2 * N_ROUND_TRIPS)); 
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* task id for the partner task */ 
+    int partner_task_id; 
+
+    /* initialise kernel */ 
+    si_kernel_init(); 
+    si_kernel_set_tick_mode(SI_TICK_MODE_TICKLESS); 
+
+    si_sem_init(&Ping_Sem, 0); 
+    si_sem_init(&Pong_Sem, 0); 
+
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], 10); 
+    si_task_create(pong_task, &Pong_Stack[STACK_SIZE-1], 5); 
+
+    /* the partner task is only run by context_switch */ 
+    partner_task_id = si_task_create(partner_task, 
+        &Partner_Stack[STACK_SIZE-1], 20); 
+    ready_list_remove(partner_task_id); 
+    Partner_Sp = tcb_storage_get_tcb_ref(partner_task_id)->stack_pointer; 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
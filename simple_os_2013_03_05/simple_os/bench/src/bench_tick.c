@@ -0,0 +1,164 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+/* bench_tick: measures the cost of the tick handler, for an 
+   increasing number of tasks waiting in the time list. None 
+   of the waiting times expire during the measurement, so the 
+   cost shall not depend on the number of waiting tasks. */ 
+
+#include "simple_os.h"
+
+#include "task.h"
+#include "tcb.h"
+#include "tcb_storage.h"
+#include "time_list.h"
+#include "interrupt.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of ticks in each measurement */ 
+#define N_TICKS 100000
+
+/* number of time list insertions in each measurement */ 
+#define N_INSERTS 100000
+
+/* number of ticks before the first waiting time expires */ 
+#define MIN_WAIT_TICKS 1000000
+
+/* stack size for the benchmark task */ 
+#define BENCH_STACK_SIZE 10000
+
+/* stack size for the waiting tasks, which never run */ 
+#define SLEEPER_STACK_SIZE 64
+
+/* number of waiting tasks for each measurement */ 
+static const int N_Sleepers[] = {1, 100, 1000, 10000}; 
+
+#define N_MEASUREMENTS (sizeof(N_Sleepers) / sizeof(N_Sleepers[0]))
+
+static stack_item Bench_Stack[BENCH_STACK_SIZE]; 
+
+static stack_item Sleeper_Stack[TCB_LIST_SIZE][SLEEPER_STACK_SIZE]; 
+
+/* task ids for the waiting tasks */ 
+static int Sleeper_Task_Id[TCB_LIST_SIZE]; 
+
+/* the tick handler, on the Linux host */ 
+void tick_handler_function(int dummy); 
+
+/* sleeper_task: a task which is placed directly in the 
+   time list, and never runs */ 
+static void sleeper_task(void)
+{
+    while (1)
+    {
+        si_wait_n_ms(1000); 
+    }
+}
+
+static void bench_task(void)
+{
+    /* number of waiting tasks */ 
+    int n_sleepers = 0; 
+    /* task id for a task in the middle of the time list */ 
+    int task_id_mid; 
+    /* time stamps */ 
+    long long t_start, t_end; 
+    /* measured times */ 
+    double tick_ns, insert_ns; 
+
+    unsigned int i; 
+    long n; 
+
+    printf("n_sleepers  tick_ns  insert_middle_ns\n"); 
+
+    for (i = 0; i < N_MEASUREMENTS; i++)
+    {
+        DISABLE_INTERRUPTS; 
+
+        /* create waiting tasks, and put them directly 
+           in the time list, with distinct waiting times */ 
+        while (n_sleepers < N_Sleepers[i])
+        {
+            Sleeper_Task_Id[n_sleepers] = task_create(sleeper_task, 
+                &Sleeper_Stack[n_sleepers][SLEEPER_STACK_SIZE-1], 10); 
+            tcb_set_wait_ticks(
+                tcb_storage_get_tcb_ref(Sleeper_Task_Id[n_sleepers]), 
+                MIN_WAIT_TICKS + n_sleepers); 
+            time_list_insert(Sleeper_Task_Id[n_sleepers]); 
+            n_sleepers++; 
+        }
+
+        /* remove and insert a task which is in the middle of 
+           the time list, keeping its position, since no 
+           ticks occur during the insertions */ 
+        task_id_mid = Sleeper_Task_Id[n_sleepers / 2]; 
+        t_start = bench_util_get_time_ns(); 
+        for (n = 0; n < N_INSERTS; n++)
+        {
+            time_list_remove(task_id_mid); 
+            time_list_insert(task_id_mid); 
+        }
+        t_end = bench_util_get_time_ns(); 
+        insert_ns = bench_util_ns_per_item(t_start, t_end, N_INSERTS); 
+
+        /* call the tick handler, as done by the timer */ 
+        t_start = bench_util_get_time_ns(); 
+        for (n = 0; n < N_TICKS; n++)
+        {
+            tick_handler_function(0); 
+        }
+        t_end = bench_util_get_time_ns(); 
+        tick_ns = bench_util_ns_per_item(t_start, t_end, N_TICKS); 
+
+        ENABLE_INTERRUPTS; 
+
+        printf("%10d  %7.1f  %16.1f\n", n_sleepers, tick_ns, insert_ns); 
+
+        /* let the waiting times start from the current tick */ 
+        DISABLE_INTERRUPTS; 
+        for (n = 0; n < n_sleepers; n++)
+        {
+            time_list_remove(Sleeper_Task_Id[n]); 
+            time_list_insert(Sleeper_Task_Id[n]); 
+        }
+        ENABLE_INTERRUPTS; 
+    }
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    /* create the benchmark task, with highest priority */ 
+    si_task_create(bench_task, &Bench_Stack[BENCH_STACK_SIZE-1], 0); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
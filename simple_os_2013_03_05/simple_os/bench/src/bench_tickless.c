@@ -0,0 +1,183 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+/* bench_tickless: runs a set of sleeping tasks, first with 
+   periodic timer interrupts and then in tickless mode, and 
+   reports the number of timer interrupts, scaled to one 
+   hour, together with the wakeup jitter. Some tasks sleep 
+   60 seconds, as the customers in the barber shop program, 
+   and some tasks sleep a shorter time. The run time for 
+   each mode, in seconds, can be given as an argument. */ 
+
+#include "simple_os.h"
+
+#include "tick_handler.h"
+#include "interrupt.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* default run time for each mode, in seconds */ 
+#define DEFAULT_RUN_SECONDS 10
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 5000
+
+/* waiting times for the sleeping tasks, in milliseconds */ 
+static const int Sleep_Ms[] = 
+    {60000, 60000, 60000, 60000, 5000, 3000, 1000, 700}; 
+
+#define N_SLEEPERS (sizeof(Sleep_Ms) / sizeof(Sleep_Ms[0]))
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+
+static stack_item Sleeper_Stack[N_SLEEPERS][STACK_SIZE]; 
+
+/* the run time for each mode, in milliseconds */ 
+static int Run_Ms; 
+
+/* index of the next sleeping task to start */ 
+static int Next_Sleeper; 
+
+/* the time when the current measurement started */ 
+static long long Phase_Start_Ns; 
+
+/* wakeup statistics for the current measurement */ 
+static long N_Wakeups; 
+static double Sum_Jitter_Us; 
+static double Max_Jitter_Us; 
+
+/* sleeper_task: sleeps repeatedly, and measures the 
+   deviation of the time between wakeups from the 
+   requested waiting time */ 
+static void sleeper_task(void)
+{
+    /* the index of this task */ 
+    int index; 
+    /* wakeup times */ 
+    long long prev_ns, now_ns; 
+    /* deviation from the waiting time */ 
+    double jitter_us; 
+
+    DISABLE_INTERRUPTS; 
+    index = Next_Sleeper++; 
+    ENABLE_INTERRUPTS; 
+
+    prev_ns = bench_util_get_time_ns(); 
+    while (1)
+    {
+        si_wait_n_ms(Sleep_Ms[index]); 
+        now_ns = bench_util_get_time_ns(); 
+
+        DISABLE_INTERRUPTS; 
+        /* only whole intervals in the current measurement count */ 
+        if (prev_ns >= Phase_Start_Ns)
+        {
+            jitter_us = (now_ns - prev_ns) / 1000.0 - 
+                Sleep_Ms[index] * 1000.0; 
+            if (jitter_us < 0)
+            {
+                jitter_us = -jitter_us; 
+            }
+            N_Wakeups++; 
+            Sum_Jitter_Us += jitter_us; 
+            if (jitter_us > Max_Jitter_Us)
+            {
+                Max_Jitter_Us = jitter_us; 
+            }
+        }
+        ENABLE_INTERRUPTS; 
+        prev_ns = now_ns; 
+    }
+}
+
+/* run_mode: runs the sleeping tasks in tick mode 
+   tick_mode, and prints the results */ 
+static void run_mode(int tick_mode, const char *name)
+{
+    /* number of timer interrupts */ 
+    unsigned long n_start, n_end; 
+    /* time stamps */ 
+    long long t_end; 
+    /* number of timer interrupts per hour */ 
+    double n_per_hour; 
+
+    si_kernel_set_tick_mode(tick_mode); 
+
+    DISABLE_INTERRUPTS; 
+    N_Wakeups = 0; 
+    Sum_Jitter_Us = 0; 
+    Max_Jitter_Us = 0; 
+    Phase_Start_Ns = bench_util_get_time_ns(); 
+    n_start = tick_handler_get_n_interrupts(); 
+    ENABLE_INTERRUPTS; 
+
+    si_wait_n_ms(Run_Ms); 
+
+    DISABLE_INTERRUPTS; 
+    n_end = tick_handler_get_n_interrupts(); 
+    t_end = bench_util_get_time_ns(); 
+    ENABLE_INTERRUPTS; 
+
+    n_per_hour = (n_end - n_start) * 3600.0e9 / (t_end - Phase_Start_Ns); 
+    printf("%-8s  %10lu  %18.0f  %9ld  %15.1f  %14.1f\n", 
+           name, n_end - n_start, n_per_hour, N_Wakeups, 
+           N_Wakeups > 0 ? Sum_Jitter_Us / N_Wakeups : 0.0, 
+           Max_Jitter_Us); 
+}
+
+static void bench_task(void)
+{
+    printf("mode      interrupts  interrupts_per_hour  wakeups"
+           "  mean_jitter_us  max_jitter_us\n"); 
+
+    run_mode(SI_TICK_MODE_PERIODIC, "periodic"); 
+    run_mode(SI_TICK_MODE_TICKLESS, "tickless"); 
+
+    exit(0); 
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int i; 
+
+    Run_Ms = 1000 * (argc > 1 ? atoi(argv[1]) : DEFAULT_RUN_SECONDS); 
+
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    /* create the benchmark task, with highest priority */ 
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], 0); 
+
+    /* create the sleeping tasks */ 
+    for (i = 0; i < N_SLEEPERS; i++)
+    {
+        si_task_create(sleeper_task, 
+            &Sleeper_Stack[i][STACK_SIZE-1], 10 + i); 
+    }
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
@@ -0,0 +1,147 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_timeout: measures the time until a timed wait returns 
+   SI_TIMEOUT, for a semaphore, a condition variable and a 
+   message, compared with the requested timeout, and the cost 
+   of si_sem_try_wait. Timed waits which end before the timeout, 
+   and non-blocking calls which would block, are also checked. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of calls when measuring si_sem_try_wait */ 
+#define N_CALLS 1000000
+
+/* the timeout, in ms */ 
+#define TIMEOUT_MS 20
+
+/* tick rate, so that a tick is shorter than the timeout */ 
+#define TICK_RATE_HZ 1000
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 10000
+
+/* priorities for the tasks */ 
+#define SIGNAL_PRIORITY 10
+#define BENCH_PRIORITY 20
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+static stack_item Signal_Stack[STACK_SIZE]; 
+
+static si_semaphore Sem; 
+static si_semaphore Mutex; 
+static si_condvar Cv; 
+
+/* signal_task: signals Sem after TIMEOUT_MS / 2 ms */ 
+static void signal_task(void)
+{
+    si_wait_n_ms(TIMEOUT_MS / 2); 
+    si_sem_signal(&Sem); 
+}
+
+/* elapsed_ms: returns the time since t_start_ns, in ms */ 
+static double elapsed_ms(long long t_start_ns)
+{
+    return (bench_util_get_time_ns() - t_start_ns) / 1000000.0; 
+}
+
+static void bench_task(void)
+{
+    char message[MESSAGE_LENGTH]; 
+    int length; 
+    int send_task_id; 
+    long long t_start; 
+    int result; 
+    long n; 
+
+    printf("call                 result  elapsed_ms  timeout_ms\n"); 
+
+    t_start = bench_util_get_time_ns(); 
+    result = si_sem_wait_timed(&Sem, TIMEOUT_MS); 
+    printf("si_sem_wait_timed    %6d  %10.2f  %10d\n", 
+           result, elapsed_ms(t_start), TIMEOUT_MS); 
+
+    si_task_create(signal_task, &Signal_Stack[STACK_SIZE-1], SIGNAL_PRIORITY); 
+    t_start = bench_util_get_time_ns(); 
+    result = si_sem_wait_timed(&Sem, TIMEOUT_MS); 
+    printf("  signalled          %6d  %10.2f  %10d\n", 
+           result, elapsed_ms(t_start), TIMEOUT_MS); 
+
+    si_sem_wait(&Mutex); 
+    t_start = bench_util_get_time_ns(); 
+    result = si_cv_wait_timed(&Cv, TIMEOUT_MS); 
+    printf("si_cv_wait_timed     %6d  %10.2f  %10d\n", 
+           result, elapsed_ms(t_start), TIMEOUT_MS); 
+    /* the mutex is held again after the timeout */ 
+    printf("  mutex held: %d\n", si_sem_try_wait(&Mutex) == SI_WOULD_BLOCK); 
+    si_sem_signal(&Mutex); 
+
+    t_start = bench_util_get_time_ns(); 
+    result = si_message_receive_timed(
+        message, &length, &send_task_id, TIMEOUT_MS); 
+    printf("si_message_receive_timed %2d  %10.2f  %10d\n", 
+           result, elapsed_ms(t_start), TIMEOUT_MS); 
+
+    /* fill the mailbox of the calling task */ 
+    si_message_set_depth(si_task_get_id(), 1); 
+    si_message_try_send(message, 1, si_task_get_id()); 
+    result = si_message_try_send(message, 1, si_task_get_id()); 
+    printf("si_message_try_send  %6d\n", result); 
+    t_start = bench_util_get_time_ns(); 
+    result = si_message_send_timed(message, 1, si_task_get_id(), TIMEOUT_MS); 
+    printf("si_message_send_timed %5d  %10.2f  %10d\n", 
+           result, elapsed_ms(t_start), TIMEOUT_MS); 
+    result = si_message_try_receive(message, &length, &send_task_id); 
+    printf("si_message_try_receive %4d\n", result); 
+
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_CALLS; n++)
+    {
+        si_sem_try_wait(&Sem); 
+    }
+    printf("si_sem_try_wait_ns  %.1f\n", 
+           bench_util_ns_per_item(t_start, bench_util_get_time_ns(), N_CALLS)); 
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    si_kernel_set_tick_rate(TICK_RATE_HZ); 
+
+    si_message_init(); 
+    si_sem_init(&Sem, 0); 
+    si_sem_init(&Mutex, 1); 
+    si_cv_init(&Cv, &Mutex); 
+
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], BENCH_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
@@ -0,0 +1,57 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "bench_util.h"
+
+#include <time.h>
+
+/* number of loop iterations per millisecond of work */ 
+static long Loops_Per_Ms = 100000; 
+
+long long bench_util_get_time_ns(void)
+{
+    struct timespec now; 
+    clock_gettime(CLOCK_MONOTONIC, &now); 
+    return (long long) now.tv_sec * 1000000000LL + now.tv_nsec; 
+}
+
+double bench_util_ns_per_item(
+    long long start_ns, long long end_ns, long n_items)
+{
+    return (double) (end_ns - start_ns) / (double) n_items; 
+}
+
+void bench_util_calibrate_work(void)
+{
+    long long t_start, t_end; 
+
+    t_start = bench_util_get_time_ns(); 
+    bench_util_do_work_ms(100); 
+    t_end = bench_util_get_time_ns(); 
+    Loops_Per_Ms = (long) (Loops_Per_Ms * 100 * 1.0e6 / (t_end - t_start)); 
+}
+
+void bench_util_do_work_ms(long n_ms)
+{
+    volatile long i; 
+    for (i = 0; i < n_ms * Loops_Per_Ms; i++)
+    {
+    }
+}
@@ -0,0 +1,42 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+/* bench_util_get_time_ns: returns the time of a monotonic 
+   host clock, in nanoseconds */ 
+long long bench_util_get_time_ns(void); 
+
+/* bench_util_ns_per_item: returns the time per item, in 
+   nanoseconds, when n_items items are handled between 
+   the time stamps start_ns and end_ns */ 
+double bench_util_ns_per_item(
+    long long start_ns, long long end_ns, long n_items); 
+
+/* bench_util_calibrate_work: calibrates bench_util_do_work_ms, 
+   and shall be called before the kernel is started */ 
+void bench_util_calibrate_work(void); 
+
+/* bench_util_do_work_ms: executes a loop for n_ms milliseconds, 
+   not counting the time when other tasks run */ 
+void bench_util_do_work_ms(long n_ms); 
+
+#endif
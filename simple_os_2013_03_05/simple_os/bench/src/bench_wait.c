@@ -0,0 +1,258 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_wait: measures the time for waking a task which waits 
+   for a semaphore, an event or a message, using si_wait_any on 
+   all three, compared with si_sem_wait, and checks that the 
+   selected object, and a timeout, are returned. The time from 
+   sending a message until it is received is also measured for 
+   si_wait_any, and for a task which polls with 
+   si_message_try_receive, waiting one tick between tries. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* number of round trips in each measurement */ 
+#define N_ROUND_TRIPS 100000
+
+/* number of messages when measuring the receive latency */ 
+#define N_LATENCY 200
+
+/* the timeout, in ms */ 
+#define TIMEOUT_MS 20
+
+/* tick rate, so that a tick is shorter than the timeout */ 
+#define TICK_RATE_HZ 1000
+
+/* stack size for the tasks */ 
+#define STACK_SIZE 10000
+
+/* priorities for the tasks */ 
+#define WAIT_PRIORITY 10
+#define BENCH_PRIORITY 20
+
+/* the objects used by the waiting task */ 
+#define ITEM_SEM 0
+#define ITEM_EVENT 1
+#define ITEM_MESSAGE 2
+#define N_ITEMS 3
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+static stack_item Wait_Stack[STACK_SIZE]; 
+
+/* the task id of the waiting task */ 
+static int Wait_Task_Id; 
+
+/* objects which the waiting task waits for */ 
+static si_semaphore Sem; 
+static si_event Event; 
+
+/* semaphore signalled by the waiting task, after each wakeup */ 
+static si_semaphore Done; 
+
+/* the object selected in the latest wakeup */ 
+static int Selected; 
+
+/* the mode of the waiting task */ 
+#define MODE_WAIT_ANY 0
+#define MODE_SEM_WAIT 1
+#define MODE_POLL 2
+static int Mode; 
+
+/* the time when the latest message was received */ 
+static long long Receive_ns; 
+
+/* wait_task: waits for the objects, and signals Done */ 
+static void wait_task(void)
+{
+    si_wait_item items[N_ITEMS]; 
+    char message[MESSAGE_LENGTH]; 
+    int length; 
+    int send_task_id; 
+
+    items[ITEM_SEM].type = SI_WAIT_SEMAPHORE; 
+    items[ITEM_SEM].object = &Sem; 
+    items[ITEM_EVENT].type = SI_WAIT_EVENT; 
+    items[ITEM_EVENT].object = &Event; 
+    items[ITEM_EVENT].mask = 1; 
+    items[ITEM_MESSAGE].type = SI_WAIT_MESSAGE; 
+    items[ITEM_MESSAGE].object = 0; 
+
+    while (1)
+    {
+        if (Mode == MODE_SEM_WAIT)
+        {
+            si_sem_wait(&Sem); 
+            Selected = ITEM_SEM; 
+        }
+        else if (Mode == MODE_POLL)
+        {
+            while (si_message_try_receive(
+                       message, &length, &send_task_id) != SI_OK)
+            {
+                si_wait_n_ms(1); 
+            }
+            Receive_ns = bench_util_get_time_ns(); 
+            Selected = ITEM_MESSAGE; 
+        }
+        else
+        {
+            Selected = si_wait_any(items, N_ITEMS, SI_WAIT_FOREVER); 
+            if (Selected == ITEM_MESSAGE)
+            {
+                si_message_receive(message, &length, &send_task_id); 
+                Receive_ns = bench_util_get_time_ns(); 
+            }
+        }
+        si_sem_signal(&Done); 
+    }
+}
+
+/* wake: makes the object item available, and 
+   waits until the waiting task has woken */ 
+static void wake(int item)
+{
+    char message[MESSAGE_LENGTH] = "wake"; 
+
+    if (item == ITEM_SEM)
+    {
+        si_sem_signal(&Sem); 
+    }
+    else if (item == ITEM_EVENT)
+    {
+        si_event_set(&Event, 1); 
+    }
+    else
+    {
+        si_message_send(message, 16, Wait_Task_Id); 
+    }
+    si_sem_wait(&Done); 
+}
+
+/* measure_wake: returns the time, in ns, for waking the 
+   waiting task using item, and sets *n_wrong to the number 
+   of wakeups where another object was selected */ 
+static double measure_wake(int mode, int item, long *n_wrong)
+{
+    long long t_start, t_end; 
+    long n; 
+
+    Mode = mode; 
+    *n_wrong = 0; 
+    t_start = bench_util_get_time_ns(); 
+    for (n = 0; n < N_ROUND_TRIPS; n++)
+    {
+        wake(item); 
+        if (Selected != item)
+        {
+            (*n_wrong)++; 
+        }
+    }
+    t_end = bench_util_get_time_ns(); 
+    return bench_util_ns_per_item(t_start, t_end, N_ROUND_TRIPS); 
+}
+
+/* measure_latency: returns the mean time, in ns, from sending 
+   a message until it is received by the waiting task */ 
+static double measure_latency(int mode)
+{
+    long long sum_ns; 
+    long long t_send; 
+    long n; 
+
+    sum_ns = 0; 
+    for (n = 0; n < N_LATENCY; n++)
+    {
+        /* let the waiting task start waiting, or polling */ 
+        si_wait_n_ms(3); 
+        Mode = mode; 
+        t_send = bench_util_get_time_ns(); 
+        wake(ITEM_MESSAGE); 
+        sum_ns += Receive_ns - t_send; 
+    }
+    return bench_util_ns_per_item(0, sum_ns, N_LATENCY); 
+}
+
+/* check_timeout: checks that si_wait_any returns -1 when 
+   no object becomes available */ 
+static void check_timeout(void)
+{
+    si_wait_item item; 
+    long long t_start, t_end; 
+    int result; 
+
+    item.type = SI_WAIT_EVENT; 
+    item.object = &Event; 
+    item.mask = 2; 
+    t_start = bench_util_get_time_ns(); 
+    result = si_wait_any(&item, 1, TIMEOUT_MS); 
+    t_end = bench_util_get_time_ns(); 
+    printf("timeout: result %d, elapsed_ms %.2f, timeout_ms %d\n", 
+           result, (t_end - t_start) / 1e6, TIMEOUT_MS); 
+    printf("no wait: result %d\n", si_wait_any(&item, 1, 0)); 
+}
+
+static void bench_task(void)
+{
+    long n_wrong; 
+    double t; 
+
+    check_timeout(); 
+
+    printf("call         object   wake_ns  wrong\n"); 
+    t = measure_wake(MODE_SEM_WAIT, ITEM_SEM, &n_wrong); 
+    printf("si_sem_wait  sem      %7.1f  %5ld\n", t, n_wrong); 
+    t = measure_wake(MODE_WAIT_ANY, ITEM_SEM, &n_wrong); 
+    printf("si_wait_any  sem      %7.1f  %5ld\n", t, n_wrong); 
+    t = measure_wake(MODE_WAIT_ANY, ITEM_EVENT, &n_wrong); 
+    printf("si_wait_any  event    %7.1f  %5ld\n", t, n_wrong); 
+    t = measure_wake(MODE_WAIT_ANY, ITEM_MESSAGE, &n_wrong); 
+    printf("si_wait_any  message  %7.1f  %5ld\n", t, n_wrong); 
+
+    printf("receive      latency_ns\n"); 
+    printf("si_wait_any  %10.1f\n", measure_latency(MODE_WAIT_ANY)); 
+    printf("poll         %10.1f\n", measure_latency(MODE_POLL)); 
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* initialise kernel */ 
+    si_kernel_init(); 
+    si_kernel_set_tick_rate(TICK_RATE_HZ); 
+
+    si_message_init(); 
+    si_sem_init(&Sem, 0); 
+    si_sem_init(&Done, 0); 
+    si_event_init(&Event); 
+
+    Wait_Task_Id = si_task_create(wait_task, 
+        &Wait_Stack[STACK_SIZE-1], WAIT_PRIORITY); 
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], BENCH_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
@@ -0,0 +1,163 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+
+/* bench_waiters: measures the cost of letting many tasks wait 
+   for a semaphore, and of waking them up, when the tasks have 
+   equal priorities, priorities which decrease or increase in 
+   the order the tasks start to wait, and mixed priorities. 
+   Each waiting task is created with si_task_create_auto, and 
+   then waits for the semaphore, so the cost includes creating 
+   the task. The difference to the equal priorities case is 
+   the cost of finding the place in the wait list. */ 
+
+#include "simple_os.h"
+
+#include "bench_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* stack size for the benchmark task and the waiting tasks */ 
+#define STACK_SIZE 10000
+#define WAITER_STACK_SIZE 1000
+
+/* number of rounds for each number of waiting tasks */ 
+#define N_ROUNDS 20
+
+/* numbers of waiting tasks */ 
+#define N_SIZES 3
+static const int Sizes[N_SIZES] = {100, 300, 1000}; 
+
+/* priority for the benchmark task, lower than the priority of 
+   the waiting tasks, which are in the range WAITER_PRIORITY_MIN .. 
+   WAITER_PRIORITY_MIN + WAITER_PRIORITY_RANGE - 1 */ 
+#define BENCH_PRIORITY 999
+#define WAITER_PRIORITY_MIN 10
+#define WAITER_PRIORITY_RANGE 980
+
+/* the orders of priorities */ 
+enum { EQUAL, DECREASING, INCREASING, MIXED, N_ORDERS }; 
+static const char *Order_Names[N_ORDERS] = 
+    {"equal", "decreasing", "increasing", "mixed"}; 
+
+static stack_item Bench_Stack[STACK_SIZE]; 
+
+/* the semaphore where the tasks wait */ 
+static si_semaphore Sem; 
+
+/* state for the random numbers for mixed priorities */ 
+static unsigned int Random_State = 1; 
+
+/* waiter_task: waits for Sem, and then exits */ 
+static void waiter_task(void)
+{
+    si_sem_wait(&Sem); 
+}
+
+/* get_priority: returns the priority for task number i, 
+   of n_waiters tasks, for the order order */ 
+static int get_priority(int order, int i, int n_waiters)
+{
+    switch (order)
+    {
+    case DECREASING: 
+        return WAITER_PRIORITY_MIN + 
+            i * WAITER_PRIORITY_RANGE / n_waiters; 
+    case INCREASING: 
+        return WAITER_PRIORITY_MIN + WAITER_PRIORITY_RANGE - 1 - 
+            i * WAITER_PRIORITY_RANGE / n_waiters; 
+    case MIXED: 
+        Random_State = Random_State * 1103515245 + 12345; 
+        return WAITER_PRIORITY_MIN + 
+            (Random_State >> 16) % WAITER_PRIORITY_RANGE; 
+    default: 
+        return WAITER_PRIORITY_MIN + WAITER_PRIORITY_RANGE / 2; 
+    }
+}
+
+/* measure: lets n_waiters tasks, with priorities in the order 
+   order, wait for Sem, and wakes them up again. The times per 
+   task, in ns, are added to *wait_ns and *wake_ns. */ 
+static void measure(int order, int n_waiters, double *wait_ns, double *wake_ns)
+{
+    long long t_start, t_mid, t_end; 
+    int i; 
+
+    t_start = bench_util_get_time_ns(); 
+    for (i = 0; i < n_waiters; i++)
+    {
+        /* the task has higher priority, and runs until it waits */ 
+        if (si_task_create_auto(waiter_task, WAITER_STACK_SIZE, 
+                get_priority(order, i, n_waiters)) < 0)
+        {
+            printf("could not create task\n"); 
+            exit(1); 
+        }
+    }
+    t_mid = bench_util_get_time_ns(); 
+    for (i = 0; i < n_waiters; i++)
+    {
+        /* the woken task has higher priority, and exits */ 
+        si_sem_signal(&Sem); 
+    }
+    t_end = bench_util_get_time_ns(); 
+    *wait_ns += bench_util_ns_per_item(t_start, t_mid, n_waiters); 
+    *wake_ns += bench_util_ns_per_item(t_mid, t_end, n_waiters); 
+}
+
+static void bench_task(void)
+{
+    double wait_ns, wake_ns; 
+    int order; 
+    int size; 
+    int round; 
+
+    printf("order        waiters   wait_ns   wake_ns\n"); 
+    for (order = 0; order < N_ORDERS; order++)
+    {
+        for (size = 0; size < N_SIZES; size++)
+        {
+            wait_ns = 0; 
+            wake_ns = 0; 
+            for (round = 0; round < N_ROUNDS; round++)
+            {
+                measure(order, Sizes[size], &wait_ns, &wake_ns); 
+            }
+            printf("%-10s  %8d  %8.1f  %8.1f\n", Order_Names[order], 
+                   Sizes[size], wait_ns / N_ROUNDS, wake_ns / N_ROUNDS); 
+        }
+    }
+
+    exit(0); 
+}
+
+int main(void)
+{
+    /* initialise kernel */ 
+    si_kernel_init(); 
+
+    si_sem_init(&Sem, 0); 
+
+    si_task_create(bench_task, &Bench_Stack[STACK_SIZE-1], BENCH_PRIORITY); 
+
+    /* start the kernel */ 
+    si_kernel_start(); 
+
+    /* will never be here! */ 
+    return 0; 
+}
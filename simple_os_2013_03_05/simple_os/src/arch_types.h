@@ -21,7 +21,7 @@
 #ifndef ARCH_TYPES_H
 #define ARCH_TYPES_H
 
-#if defined BUILD_X86_64_MAC_HOST
+#if defined BUILD_X86_64_HOST || defined BUILD_X86_64_MAC_HOST
 
 typedef long stack_item; 
 typedef long mem_address; 
@@ -0,0 +1,49 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "bitmap.h"
+
+#ifndef __GNUC__
+
+/* table for finding the index of an isolated bit, using 
+   a de Bruijn sequence */ 
+static const int De_Bruijn_Bit_Position[BITMAP_WORD_SIZE] = 
+{
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8, 
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+}; 
+
+#endif
+
+int bitmap_find_first_set(unsigned int word)
+{
+    if (word == 0)
+    {
+        return -1; 
+    }
+#ifdef __GNUC__
+    /* one instruction on the targets we build for */ 
+    return __builtin_ctz(word); 
+#else
+    /* isolate the least significant bit, and look up its index */ 
+    return De_Bruijn_Bit_Position[
+        ((word & (~word + 1)) * 0x077CB531U) >> 27]; 
+#endif
+}
@@ -20,7 +20,7 @@
 
 #include "console.h"
 
-#if defined BUILD_X86_HOST || BUILD_X86_64_MAC_HOST
+#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST || defined BUILD_X86_64_MAC_HOST
 
 #include <stdio.h>
 
@@ -62,7 +62,7 @@ volatile unsigned char * const UART_LSR = (unsigned char *) UART_LSR_ADDR;
 
 #endif
 
-#if defined BUILD_X86_HOST || defined BUILD_X86_64_MAC_HOST
+#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST || defined BUILD_X86_64_MAC_HOST
 
 void console_put_char(char c)
 {
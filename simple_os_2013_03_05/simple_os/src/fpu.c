@@ -0,0 +1,149 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "fpu.h"
+
+#include "tcb.h"
+#include "tcb_storage.h"
+#include "task_id_list.h"
+#include "smp.h"
+
+#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
+
+/* the FPU state is saved by fxsave and restored by fxrstor */ 
+#define FPU_SUPPORTED
+
+/* size of the state saved by fxsave, in bytes */ 
+#define FPU_STATE_SIZE 512
+
+/* an area for the saved FPU state, aligned as 
+   required by fxsave */ 
+typedef struct
+{
+    unsigned char state[FPU_STATE_SIZE]; 
+} __attribute__((aligned(16))) fpu_context_type; 
+
+/* the FPU contexts */ 
+static fpu_context_type FPU_Context[FPU_CONTEXT_COUNT]; 
+
+/* the task using each FPU context, or TASK_ID_INVALID */ 
+static int FPU_Context_Task_Id[FPU_CONTEXT_COUNT]; 
+
+/* save_state: saves the FPU state in context */ 
+static void save_state(fpu_context_type *context)
+{
+    __asm__ volatile ("fxsave %0" : "=m" (*context)); 
+}
+
+/* restore_state: restores the FPU state from context */ 
+static void restore_state(fpu_context_type *context)
+{
+    __asm__ volatile ("fxrstor %0" : : "m" (*context)); 
+}
+
+#endif
+
+/* number of times the FPU state has been saved and restored */ 
+static long N_Switches; 
+
+void fpu_init(void)
+{
+#ifdef FPU_SUPPORTED
+    int i; 
+    for (i = 0; i < FPU_CONTEXT_COUNT; i++)
+    {
+        FPU_Context_Task_Id[i] = TASK_ID_INVALID; 
+    }
+#endif
+    N_Switches = 0; 
+}
+
+int fpu_task_use(int task_id)
+{
+#ifdef FPU_SUPPORTED
+    /* the TCB for the task */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    int i; 
+
+    if (tcb->fpu_context >= 0)
+    {
+        /* the task has a context already */ 
+        return 0; 
+    }
+    for (i = 0; i < FPU_CONTEXT_COUNT; i++)
+    {
+        if (FPU_Context_Task_Id[i] == TASK_ID_INVALID)
+        {
+            /* the loaded FPU state is saved in the 
+               context when the task stops running */ 
+            FPU_Context_Task_Id[i] = task_id; 
+            tcb->fpu_context = i; 
+            return 0; 
+        }
+    }
+#endif
+    return -1; 
+}
+
+void fpu_task_release(int task_id)
+{
+#ifdef FPU_SUPPORTED
+    /* the TCB for the task */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+
+    if (tcb->fpu_context >= 0)
+    {
+        FPU_Context_Task_Id[tcb->fpu_context] = TASK_ID_INVALID; 
+        tcb->fpu_context = -1; 
+    }
+#endif
+}
+
+void fpu_switch(int task_id_old, int task_id_new)
+{
+#ifdef FPU_SUPPORTED
+    /* the FPU contexts for the old and the new task */ 
+    int old_context = tcb_storage_get_tcb_ref(task_id_old)->fpu_context; 
+    int context = tcb_storage_get_tcb_ref(task_id_new)->fpu_context; 
+
+    /* the state is saved when task_id_old stops running, and 
+       restored each time task_id_new starts running. The loaded 
+       state cannot be kept for a later switch, since a switch 
+       made by an interrupt handler runs in a signal handler, 
+       where the FPU holds the initial state given by the host, 
+       and the state of the interrupted task is stored in its 
+       signal frame. A task which is interrupted gets its state 
+       back from the signal frame when it resumes. */ 
+    if (old_context >= 0)
+    {
+        save_state(&FPU_Context[old_context]); 
+    }
+    if (context >= 0)
+    {
+        restore_state(&FPU_Context[context]); 
+        N_Switches++; 
+    }
+#endif
+}
+
+long fpu_get_n_switches(void)
+{
+    return N_Switches; 
+}
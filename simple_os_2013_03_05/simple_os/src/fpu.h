@@ -0,0 +1,55 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef FPU_H
+#define FPU_H
+
+/* maximum number of tasks with a private FPU context, which 
+   may be set at compile time, e.g. by -DFPU_CONTEXT_COUNT=20 */ 
+#ifndef FPU_CONTEXT_COUNT
+#define FPU_CONTEXT_COUNT 8
+#endif
+
+/* fpu_init: perform initialisation */ 
+void fpu_init(void); 
+
+/* fpu_task_use: gives the running task task_id a private 
+   FPU context, holding the FPU and SSE state, including 
+   rounding modes. Returns 0, or -1 if no FPU context is 
+   available, or if FPU contexts are not supported for the 
+   target. */ 
+int fpu_task_use(int task_id); 
+
+/* fpu_task_release: frees the private FPU context of 
+   task_id, if any, when the task is deleted */ 
+void fpu_task_release(int task_id); 
+
+/* fpu_switch: called when task_id_new is about to run, 
+   instead of task_id_old. The FPU state is saved if task_id_old 
+   has a private FPU context, and restored if task_id_new has 
+   one. Tasks without a private FPU context leave the FPU 
+   state untouched. */ 
+void fpu_switch(int task_id_old, int task_id_new); 
+
+/* fpu_get_n_switches: returns the number of times the 
+   FPU state has been saved and restored */ 
+long fpu_get_n_switches(void); 
+
+#endif
@@ -0,0 +1,116 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "idle.h"
+
+#include "interrupt.h"
+#include "timer.h"
+#include "smp.h"
+#include "schedule.h"
+
+#ifdef BUILD_X86_WIN_HOST
+
+/* Windows API include file */ 
+#include <windows.h>
+
+#endif
+
+#ifdef TIMER_CLOCK
+#include <stddef.h>
+#endif
+
+/* the total idle time */ 
+static long long Idle_Time_Us; 
+
+#ifdef TIMER_CLOCK
+
+/* the idle task is sleeping in idle_wait, for each CPU */ 
+static int Idle_Waiting[SMP_N_CPUS]; 
+
+/* the time when the sleeping in idle_wait started, for each CPU */ 
+static long long Idle_Start_Us[SMP_N_CPUS]; 
+
+void idle_wait(void)
+{
+    /* the signal mask used while sleeping */ 
+    sigset_t wait_mask; 
+    /* the calling CPU */ 
+    int cpu = smp_get_cpu_id(); 
+
+    DISABLE_INTERRUPTS; 
+
+#ifdef SMP_HOST
+    /* take a ready task from another CPU, if there is one */ 
+    schedule(); 
+#endif
+
+    /* sleep with the timer and input signals unblocked. The 
+       waiting ends when the interrupt has been handled, and 
+       the idle task runs again. */ 
+    sigprocmask(SIG_BLOCK, NULL, &wait_mask); 
+    sigdelset(&wait_mask, TIMER_SIGNAL); 
+    sigdelset(&wait_mask, INPUT_SIGNAL); 
+#ifdef SMP_HOST
+    /* the waiting also ends when another CPU interrupts, and 
+       the kernel lock is released while sleeping. Interrupts 
+       arriving before sigsuspend remain pending until then. */ 
+    sigdelset(&wait_mask, SMP_IPI_SIGNAL); 
+#endif
+    Idle_Start_Us[cpu] = timer_get_time_us(); 
+    Idle_Waiting[cpu] = 1; 
+#ifdef SMP_HOST
+    smp_unlock(); 
+#endif
+    sigsuspend(&wait_mask); 
+
+    ENABLE_INTERRUPTS; 
+}
+
+void idle_register_interrupt(void)
+{
+    /* the calling CPU */ 
+    int cpu = smp_get_cpu_id(); 
+
+    if (Idle_Waiting[cpu])
+    {
+        Idle_Time_Us += timer_get_time_us() - Idle_Start_Us[cpu]; 
+        Idle_Waiting[cpu] = 0; 
+    }
+}
+
+#else
+
+void idle_wait(void)
+{
+#ifdef BUILD_X86_WIN_HOST
+    Sleep(10); 
+#endif
+}
+
+void idle_register_interrupt(void)
+{
+}
+
+#endif
+
+long long idle_get_time_us(void)
+{
+    return Idle_Time_Us; 
+}
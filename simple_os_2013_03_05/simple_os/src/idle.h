@@ -0,0 +1,39 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef IDLE_H
+#define IDLE_H
+
+/* idle_wait: lets the host process sleep until the next 
+   timer interrupt. Called repeatedly by the idle task. 
+   On the Linux host, the time spent sleeping is accounted 
+   as idle time. */ 
+void idle_wait(void); 
+
+/* idle_register_interrupt: registers that an interrupt 
+   has occurred, which ends an ongoing wait in idle_wait. 
+   Shall be called first in the tick handler. */ 
+void idle_register_interrupt(void); 
+
+/* idle_get_time_us: returns the total idle time, 
+   in microseconds */ 
+long long idle_get_time_us(void); 
+
+#endif
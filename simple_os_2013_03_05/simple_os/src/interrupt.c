@@ -24,6 +24,8 @@
 
 #include "exceptions.h"
 
+#include "timer.h"
+
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST || defined BUILD_X86_MAC_HOST
 
 #ifdef BUILD_X86_WIN_HOST
@@ -49,25 +51,102 @@ void enable_timer_interrupts()
 
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "schedule.h"
+#include "idle.h"
+#include "smp.h"
+
+/* function called at input interrupts, see interrupt_set_input */ 
+static int (*Input_Function)(void); 
+
+/* input_handler: handles an input interrupt, by calling 
+   Input_Function, and scheduling if tasks have become ready */ 
+static void input_handler(int signal)
+{
+#ifdef SMP_HOST
+    /* the other CPUs may use the kernel data */ 
+    smp_lock(); 
+#endif
+    /* end the sleeping in the idle task, if ongoing */ 
+    idle_register_interrupt(); 
+    if (Input_Function != 0 && Input_Function() > 0)
+    {
+        schedule(); 
+    }
+#ifdef SMP_HOST
+    smp_unlock(); 
+#endif
+}
+
+void interrupt_set_handler(int signal, void (*handler)(int))
+{
+#ifdef SMP_HOST
+    smp_set_interrupt_handler(signal, handler); 
+#else
+    struct sigaction action; 
+
+    memset(&action, 0, sizeof(action)); 
+    action.sa_handler = handler; 
+    sigemptyset(&action.sa_mask); 
+    sigaddset(&action.sa_mask, TIMER_SIGNAL); 
+    sigaddset(&action.sa_mask, INPUT_SIGNAL); 
+    action.sa_flags = SA_RESTART; 
+    sigaction(signal, &action, NULL); 
+#endif
+}
+
+void interrupt_set_input(int fd, int (*input_function)(void))
+{
+    Input_Function = input_function; 
+    interrupt_set_handler(INPUT_SIGNAL, input_handler); 
+    /* let the host signal this process when input arrives */ 
+    fcntl(fd, F_SETOWN, getpid()); 
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_ASYNC); 
+}
+
+#ifdef SMP_HOST
+
+/* with SMP_HOST, disabled interrupts also means 
+   that the kernel lock is held */ 
+
+void disable_interrupts(void)
+{
+    smp_block_interrupts(); 
+    smp_lock(); 
+}
+
+void enable_interrupts(void)
+{
+    smp_unlock(); 
+    smp_unblock_interrupts(); 
+}
+
+#else
 
 void disable_interrupts(void)
 {
    sigset_t set; 
    sigemptyset(&set); 
-   sigaddset(&set, SIGVTALRM);  
+   sigaddset(&set, TIMER_SIGNAL);  
+   sigaddset(&set, INPUT_SIGNAL);  
    sigprocmask(SIG_BLOCK, &set, NULL); 
-   // sigblock(sigmask(SIGVTALRM));
 }
 
 void enable_interrupts(void)
 {
    sigset_t set; 
    sigemptyset(&set); 
-   sigaddset(&set, SIGVTALRM);  
+   sigaddset(&set, TIMER_SIGNAL);  
+   sigaddset(&set, INPUT_SIGNAL);  
    sigprocmask(SIG_UNBLOCK, &set, NULL); 
    // sigsetmask(0); 
 }
 
+#endif
+
 void enable_timer_interrupts()
 {
 }
@@ -59,6 +59,29 @@ void enable_interrupts(void);
 
 #endif
 
+#if (defined BUILD_X86_HOST || defined BUILD_X86_64_HOST) && \
+    !defined BUILD_X86_WIN_HOST
+
+#include <signal.h>
+
+/* the signal used for input interrupts, which is raised 
+   by the host when input arrives, see interrupt_set_input */ 
+#define INPUT_SIGNAL SIGIO
+
+/* interrupt_set_handler: installs handler for signal, which 
+   is used as an interrupt. The handler runs with the timer 
+   signal and INPUT_SIGNAL blocked. */ 
+void interrupt_set_handler(int signal, void (*handler)(int)); 
+
+/* interrupt_set_input: makes the host raise INPUT_SIGNAL when 
+   input arrives on the file descriptor fd, and calls 
+   input_function at each such interrupt, with interrupts 
+   disabled. The function returns the number of tasks it has 
+   made ready, and shall not call schedule. */ 
+void interrupt_set_input(int fd, int (*input_function)(void)); 
+
+#endif
+
 void enable_timer_interrupts(); 
 
 #endif
@@ -22,53 +22,438 @@
 #include "tcb.h"
 #include "tcb_storage.h"
 #include "task_id_list.h"
-#include "tcb_list.h"
+#include "bitmap.h"
 #include "console.h"
+#include "smp.h"
+#include "task.h"
 
 /* fig_begin ready_list */ 
-/* size of ready-list */ 
-#define READY_LIST_SIZE TCB_LIST_SIZE
+/* number of groups of priority levels, where each group 
+   is represented by one bit in Ready_Group_Bitmap */ 
+#define N_PRIORITY_GROUPS \
+    ((N_PRIORITY_LEVELS + BITMAP_WORD_SIZE - 1) / BITMAP_WORD_SIZE)
 
-/* the list of ready-to-run tasks */ 
-static int Ready_List[READY_LIST_SIZE]; 
+/* the list of ready-to-run tasks, stored as one FIFO list 
+   for each priority level. The lists are linked through 
+   the TCBs, using next_task_id and prev_task_id. There is 
+   one list for each CPU, see smp.h. */ 
+static int Ready_First[SMP_N_CPUS][N_PRIORITY_LEVELS]; 
+static int Ready_Last[SMP_N_CPUS][N_PRIORITY_LEVELS]; 
+
+/* bitmaps for non-empty priority levels. Bit i in 
+   Ready_Group_Bitmap is set when some level in group i 
+   is non-empty, and bit j in Ready_Level_Bitmap[i] is set 
+   when level i*BITMAP_WORD_SIZE + j is non-empty */ 
+static unsigned int Ready_Group_Bitmap[SMP_N_CPUS]; 
+static unsigned int Ready_Level_Bitmap[SMP_N_CPUS][N_PRIORITY_GROUPS]; 
 /* fig_end ready_list */ 
 
+#ifdef EDF_SCHEDULING
+
+/* the ready tasks which have a deadline, i.e. the periodic 
+   tasks, stored as a binary heap ordered by absolute 
+   deadline. These tasks have higher priority than the 
+   tasks in the priority levels. */ 
+static int Edf_Heap[TCB_LIST_SIZE]; 
+static int Edf_Heap_Size; 
+
+/* get_deadline: returns the absolute deadline for task_id */ 
+static long long get_deadline(int task_id)
+{
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    return tcb->release_us + tcb->deadline_us; 
+}
+
+/* heap_set: stores task_id at position index in the heap */ 
+static void heap_set(int index, int task_id)
+{
+    Edf_Heap[index] = task_id; 
+    tcb_storage_get_tcb_ref(task_id)->heap_index = index; 
+}
+
+/* heap_sift_up: moves the task at position index towards 
+   the top of the heap, until its parent has an earlier 
+   or equal deadline */ 
+static void heap_sift_up(int index)
+{
+    int task_id = Edf_Heap[index]; 
+    long long deadline = get_deadline(task_id); 
+    int parent; 
+
+    while (index > 0)
+    {
+        parent = (index - 1) / 2; 
+        if (get_deadline(Edf_Heap[parent]) <= deadline)
+        {
+            break; 
+        }
+        heap_set(index, Edf_Heap[parent]); 
+        index = parent; 
+    }
+    heap_set(index, task_id); 
+}
+
+/* heap_sift_down: moves the task at position index towards 
+   the bottom of the heap, until its children have later 
+   or equal deadlines */ 
+static void heap_sift_down(int index)
+{
+    int task_id = Edf_Heap[index]; 
+    long long deadline = get_deadline(task_id); 
+    int child; 
+
+    while ((child = 2 * index + 1) < Edf_Heap_Size)
+    {
+        /* select the child with the earliest deadline */ 
+        if (child + 1 < Edf_Heap_Size && 
+            get_deadline(Edf_Heap[child + 1]) < 
+            get_deadline(Edf_Heap[child]))
+        {
+            child++; 
+        }
+        if (deadline <= get_deadline(Edf_Heap[child]))
+        {
+            break; 
+        }
+        heap_set(index, Edf_Heap[child]); 
+        index = child; 
+    }
+    heap_set(index, task_id); 
+}
+
+/* heap_insert: inserts task_id in the heap */ 
+static void heap_insert(int task_id)
+{
+    heap_set(Edf_Heap_Size, task_id); 
+    Edf_Heap_Size++; 
+    heap_sift_up(Edf_Heap_Size - 1); 
+}
+
+/* heap_remove: removes task_id from the heap */ 
+static void heap_remove(int task_id)
+{
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    int index = tcb->heap_index; 
+
+    /* move the last task to the free position */ 
+    Edf_Heap_Size--; 
+    if (index != Edf_Heap_Size)
+    {
+        heap_set(index, Edf_Heap[Edf_Heap_Size]); 
+        heap_sift_up(index); 
+        heap_sift_down(index); 
+    }
+    tcb->heap_index = -1; 
+}
+
+#endif
+
+/* set_level_non_empty: marks priority level as non-empty, 
+   in the ready list for cpu */ 
+static void set_level_non_empty(int cpu, int level)
+{
+    int group = level / BITMAP_WORD_SIZE; 
+    Ready_Level_Bitmap[cpu][group] |= 1U << (level % BITMAP_WORD_SIZE); 
+    Ready_Group_Bitmap[cpu] |= 1U << group; 
+}
+
+/* set_level_empty: marks priority level as empty, 
+   in the ready list for cpu */ 
+static void set_level_empty(int cpu, int level)
+{
+    int group = level / BITMAP_WORD_SIZE; 
+    Ready_Level_Bitmap[cpu][group] &= ~(1U << (level % BITMAP_WORD_SIZE)); 
+    if (Ready_Level_Bitmap[cpu][group] == 0)
+    {
+        Ready_Group_Bitmap[cpu] &= ~(1U << group); 
+    }
+}
+
 void ready_list_init(void)
 {
-    task_id_list_reset(Ready_List, READY_LIST_SIZE); 
+    int i; 
+    int cpu; 
+    for (cpu = 0; cpu < SMP_N_CPUS; cpu++)
+    {
+        for (i = 0; i < N_PRIORITY_LEVELS; i++)
+        {
+            Ready_First[cpu][i] = TASK_ID_INVALID; 
+            Ready_Last[cpu][i] = TASK_ID_INVALID; 
+        }
+        for (i = 0; i < N_PRIORITY_GROUPS; i++)
+        {
+            Ready_Level_Bitmap[cpu][i] = 0; 
+        }
+        Ready_Group_Bitmap[cpu] = 0; 
+    }
+#ifdef EDF_SCHEDULING
+    Edf_Heap_Size = 0; 
+#endif
+}
+
+/* level_insert: inserts task_id last in the list 
+   for its priority level */ 
+static void level_insert(int task_id)
+{
+    /* the TCB for the task */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    /* the priority level where the task is stored */ 
+    int level = tcb->priority; 
+    /* the CPU whose list stores the task */ 
+    int cpu = tcb->cpu; 
+
+    /* insert last in the list for this priority level */ 
+    tcb->next_task_id = TASK_ID_INVALID; 
+    tcb->prev_task_id = Ready_Last[cpu][level]; 
+    if (Ready_Last[cpu][level] == TASK_ID_INVALID)
+    {
+        Ready_First[cpu][level] = task_id; 
+        set_level_non_empty(cpu, level); 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(Ready_Last[cpu][level])->next_task_id = 
+            task_id; 
+    }
+    Ready_Last[cpu][level] = task_id; 
+}
+
+/* level_remove: removes task_id from the list 
+   for its priority level */ 
+static void level_remove(int task_id)
+{
+    /* the TCB for the task */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    /* the priority level where the task is stored */ 
+    int level = tcb->priority; 
+    /* the CPU whose list stores the task */ 
+    int cpu = tcb->cpu; 
+
+    /* unlink the task from the list for this priority level */ 
+    if (tcb->prev_task_id == TASK_ID_INVALID)
+    {
+        Ready_First[cpu][level] = tcb->next_task_id; 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(tcb->prev_task_id)->next_task_id = 
+            tcb->next_task_id; 
+    }
+    if (tcb->next_task_id == TASK_ID_INVALID)
+    {
+        Ready_Last[cpu][level] = tcb->prev_task_id; 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(tcb->next_task_id)->prev_task_id = 
+            tcb->prev_task_id; 
+    }
+    if (Ready_First[cpu][level] == TASK_ID_INVALID)
+    {
+        set_level_empty(cpu, level); 
+    }
+
+    tcb->next_task_id = TASK_ID_INVALID; 
+    tcb->prev_task_id = TASK_ID_INVALID; 
 }
 
 void ready_list_insert(int task_id)
 {
-    task_id_list_insert(Ready_List, READY_LIST_SIZE, task_id); 
+    /* the TCB for the task */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+
+    /* a task is only stored once in the ready list */ 
+    if (tcb->is_ready)
+    {
+        return; 
+    }
+
+#ifdef EDF_SCHEDULING
+    if (tcb->is_periodic)
+    {
+        heap_insert(task_id); 
+    }
+    else
+#endif
+    {
+        level_insert(task_id); 
+    }
+    tcb->is_ready = 1; 
+    /* a task which is not running has become ready, e.g. from 
+       a semaphore, a message or a timer. The time until it runs 
+       is recorded by task_switch. A task which is moved within 
+       the ready list keeps its time. */ 
+    if (!tcb->latency_pending && 
+        task_get_task_id_running_on(tcb->cpu) != task_id)
+    {
+        tcb->latency_pending = 1; 
+        tcb->ready_ns = task_get_time_ns(); 
+    }
+#ifdef SMP_HOST
+    smp_notify_ready(task_id); 
+#endif
     // console_put_string("ready_inserted "); 
     // console_put_hex(task_id); 
 }
 
 int ready_list_get_task_id_highest_prio(void)
 {
-    /* a pointer to a TCB, to be used as a pointer
-       to the common TCB list */
-    task_control_block *tcb_list_ref;
+    /* group and priority level with highest priority */ 
+    int group; 
+    int level; 
+    /* the calling CPU */ 
+    int cpu = smp_get_cpu_id(); 
 
-    /* task_id for task with highest priority */
-    int task_id_highest_prio;
+#ifdef EDF_SCHEDULING
+    /* tasks with a deadline run first, the task 
+       with the earliest deadline first */ 
+    if (Edf_Heap_Size > 0)
+    {
+        return Edf_Heap[0]; 
+    }
+#endif
 
-    /* get a pointer to the common TCB list */
-    tcb_list_ref = tcb_storage_get_tcb_list_ref();
+    /* check if there are no ready tasks */ 
+    if (Ready_Group_Bitmap[cpu] == 0)
+    {
+        return TASK_ID_INVALID; 
+    }
 
-    /* get task_id for task with highest priority */
-    task_id_highest_prio = tcb_list_get_task_id_highest_prio(
-        tcb_list_ref, tcb_storage_get_tcb_list_size(),
-        Ready_List, READY_LIST_SIZE);
+    /* find the highest priority level which is non-empty */ 
+    group = bitmap_find_first_set(Ready_Group_Bitmap[cpu]); 
+    level = group * BITMAP_WORD_SIZE + 
+        bitmap_find_first_set(Ready_Level_Bitmap[cpu][group]); 
 
-    /* return the task_id */
-    return task_id_highest_prio;
+    /* return the first task at this level */
+    return Ready_First[cpu][level]; 
 }
 
 void ready_list_remove(int task_id)
 {
-    task_id_list_remove(Ready_List, READY_LIST_SIZE, task_id); 
+    /* the TCB for the task */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+
+    /* nothing to do if the task is not in the ready list */ 
+    if (!tcb->is_ready)
+    {
+        return; 
+    }
+
+#ifdef EDF_SCHEDULING
+    if (tcb->heap_index >= 0)
+    {
+        heap_remove(task_id); 
+    }
+    else
+#endif
+    {
+        level_remove(task_id); 
+    }
+    tcb->is_ready = 0; 
 }
 
+void ready_list_change_priority(int task_id, int priority)
+{
+    /* the TCB for the task */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    /* the task is ready to run */ 
+    int is_ready = tcb->is_ready; 
+
+    if (is_ready)
+    {
+        ready_list_remove(task_id); 
+    }
+    tcb->priority = priority; 
+    if (is_ready)
+    {
+        ready_list_insert(task_id); 
+    }
+}
+
+#ifdef SMP_HOST
+
+/* find_level: returns the highest priority level, starting 
+   from level, which is non-empty in the ready list for cpu, 
+   or N_PRIORITY_LEVELS if there is no such level */ 
+static int find_level(int cpu, int level)
+{
+    int group = level / BITMAP_WORD_SIZE; 
+    unsigned int bits; 
+
+    if (level >= N_PRIORITY_LEVELS)
+    {
+        return N_PRIORITY_LEVELS; 
+    }
+    bits = Ready_Level_Bitmap[cpu][group] & 
+        (~0U << (level % BITMAP_WORD_SIZE)); 
+    while (bits == 0)
+    {
+        group++; 
+        if (group >= N_PRIORITY_GROUPS)
+        {
+            return N_PRIORITY_LEVELS; 
+        }
+        bits = Ready_Level_Bitmap[cpu][group]; 
+    }
+    return group * BITMAP_WORD_SIZE + bitmap_find_first_set(bits); 
+}
+
+int ready_list_steal_task(void)
+{
+    /* the calling CPU, and another CPU */ 
+    int cpu = smp_get_cpu_id(); 
+    int other_cpu; 
+    /* the task with highest priority on the calling CPU */ 
+    int task_id_highest_prio = ready_list_get_task_id_highest_prio(); 
+    /* the task to take, and its priority */ 
+    int task_id_steal = TASK_ID_INVALID; 
+    int steal_priority = N_PRIORITY_LEVELS; 
+    /* the task running on the other CPU */ 
+    int task_id_running; 
+
+    int level; 
+    int task_id; 
+
+    if (task_id_highest_prio != TASK_ID_INVALID)
+    {
+        steal_priority = 
+            tcb_storage_get_tcb_ref(task_id_highest_prio)->priority; 
+    }
+
+    /* look for a ready task, which is not running, with 
+       higher priority than the tasks on the calling CPU */ 
+    for (other_cpu = 0; other_cpu < SMP_N_CPUS; other_cpu++)
+    {
+        if (other_cpu == cpu)
+        {
+            continue; 
+        }
+        task_id_running = task_get_task_id_running_on(other_cpu); 
+        for (level = find_level(other_cpu, 0); level < steal_priority; 
+             level = find_level(other_cpu, level + 1))
+        {
+            task_id = Ready_First[other_cpu][level]; 
+            if (task_id == task_id_running)
+            {
+                task_id = tcb_storage_get_tcb_ref(task_id)->next_task_id; 
+            }
+            if (task_id != TASK_ID_INVALID)
+            {
+                task_id_steal = task_id; 
+                steal_priority = level; 
+                break; 
+            }
+        }
+    }
+
+    /* move the task to the ready list of the calling CPU */ 
+    if (task_id_steal != TASK_ID_INVALID)
+    {
+        level_remove(task_id_steal); 
+        tcb_storage_get_tcb_ref(task_id_steal)->cpu = cpu; 
+        level_insert(task_id_steal); 
+    }
+    return task_id_steal; 
+}
 
+#endif
@@ -24,15 +24,37 @@
 /* ready_list_init: initialise the ready list */ 
 void ready_list_init(void); 
 
-/* ready_list_insert: inserts task_id in list of ready-to-run tasks */ 
+/* ready_list_insert: inserts task_id in list of ready-to-run tasks, 
+   last among the tasks with the same priority */ 
 void ready_list_insert(int task_id); 
 
 /* ready_list_get_task_id_highest_prio: get the task id for the task
-   with the highest priority, among the tasks in the ready list */ 
+   with the highest priority, among the tasks in the ready list. 
+   Tasks with the same priority are selected in the order they 
+   were inserted. When built with EDF_SCHEDULING, periodic tasks 
+   are selected before all other tasks, in order of their absolute 
+   deadlines. TASK_ID_INVALID is returned if the ready list 
+   is empty. */ 
 int ready_list_get_task_id_highest_prio(void); 
 
 /* ready_list_remove: removes task_id from the list of ready-to-run tasks */ 
 void ready_list_remove(int task_id); 
 
+/* ready_list_change_priority: sets the priority of task_id 
+   to priority. If the task is ready to run, it is moved 
+   last among the tasks with the new priority. */ 
+void ready_list_change_priority(int task_id, int priority); 
+
+#ifdef SMP_HOST
+
+/* ready_list_steal_task: moves the ready task, which is not 
+   running, with highest priority, from the ready list of 
+   another CPU to the ready list of the calling CPU, if the 
+   task has higher priority than the tasks on the calling 
+   CPU. Returns the task id of the moved task, or 
+   TASK_ID_INVALID if no task was moved. */ 
+int ready_list_steal_task(void); 
+
 #endif
 
+#endif
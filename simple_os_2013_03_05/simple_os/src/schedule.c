@@ -22,6 +22,9 @@
 
 #include "ready_list.h"
 #include "task.h"
+#include "task_id_list.h"
+#include "tcb.h"
+#include "tcb_storage.h"
 
 #include "console.h"
 
@@ -36,6 +39,11 @@ void schedule(void)
        highest priority */ 
     int task_id_highest_prio; 
 
+#ifdef SMP_HOST
+    /* task id for a task taken from another CPU */ 
+    int task_id_stolen; 
+#endif
+
     /* get task id for the running task */ 
     task_id_running = task_get_task_id_running(); 
 
@@ -44,6 +52,15 @@ void schedule(void)
     task_id_highest_prio = 
         ready_list_get_task_id_highest_prio(); 
 
+#ifdef SMP_HOST
+    /* prefer a task with higher priority from another CPU */ 
+    task_id_stolen = ready_list_steal_task(); 
+    if (task_id_stolen != TASK_ID_INVALID)
+    {
+        task_id_highest_prio = task_id_stolen; 
+    }
+#endif
+
     /* check if a task switch shall be performed */ 
     if (task_id_highest_prio != task_id_running)
     {
@@ -56,3 +73,30 @@ void schedule(void)
     }
 }
 /* fig_end schedule */ 
+
+void schedule_handoff(int task_id)
+{
+#if defined SMP_HOST || defined EDF_SCHEDULING
+    /* the ready lists of other CPUs, or deadlines, are needed */ 
+    schedule(); 
+#else
+    /* task id for the running task */ 
+    int task_id_running = task_get_task_id_running(); 
+    /* a pointer to the TCB for the running task */ 
+    task_control_block *tcb_running = tcb_storage_get_tcb_ref(task_id_running); 
+    /* the priority of task_id */ 
+    int priority = tcb_storage_get_tcb_ref(task_id)->priority; 
+
+    /* no other ready task has higher priority than the 
+       running task, so task_id can be selected directly */ 
+    if (priority < tcb_running->priority || 
+        (priority == tcb_running->priority && !tcb_running->is_ready))
+    {
+        task_switch(task_id_running, task_id); 
+    }
+    else if (!tcb_running->is_ready)
+    {
+        schedule(); 
+    }
+#endif
+}
@@ -23,4 +23,12 @@
 
 void schedule(void); 
 
+/* schedule_handoff: performs scheduling, as schedule, when 
+   task_id has been made ready by the running task. When task_id 
+   has higher priority than the running task, or the same priority 
+   and the running task has been removed from the ready list, 
+   task_id is selected without searching the ready list. When 
+   built with SMP_HOST or EDF_SCHEDULING, schedule is called. */ 
+void schedule_handoff(int task_id); 
+
 #endif
@@ -21,6 +21,7 @@
 #include "si_comm.h"
 
 #include "console.h"
+#include "interrupt.h"
 
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
 
@@ -308,6 +309,45 @@ int si_comm_read(char message_data[], int message_data_size)
 #endif
 }
 
+int si_comm_poll(void)
+{
+#ifdef BUILD_ARM_BB
+    return 0; 
+#else
+    fd_set read_fds; 
+    struct timeval waitd; 
+
+    if (!Connection_Ok)
+    {
+        return 0; 
+    }
+
+    waitd.tv_sec = 0;  
+    waitd.tv_usec = 0; 
+
+    FD_ZERO(&read_fds);
+    FD_SET(newsockfd, &read_fds); 
+    
+    return select(newsockfd + 1, &read_fds, NULL, NULL, &waitd) > 0 && 
+        FD_ISSET(newsockfd, &read_fds); 
+#endif
+}
+
+int si_comm_set_input_function(int (*input_function)(void))
+{
+#if (defined BUILD_X86_HOST || defined BUILD_X86_64_HOST) && \
+    !defined BUILD_X86_WIN_HOST
+    if (!Connection_Ok)
+    {
+        return 0; 
+    }
+    interrupt_set_input(newsockfd, input_function); 
+    return 1; 
+#else
+    return 0; 
+#endif
+}
+
 int si_comm_write(const char message_data[])
 {
 #ifdef BUILD_ARM_BB
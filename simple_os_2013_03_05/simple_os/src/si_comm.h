@@ -31,6 +31,17 @@ void si_comm_open(void);
    Returns SI_COMM_OK if reading was ok. */  
 int si_comm_read(char message_data[], int message_data_size); 
 
+/* si_comm_poll: returns nonzero if a message can be read, 
+   without reading it. May be called with interrupts disabled. 
+   On the target, where this is not checked, 0 is returned. */ 
+int si_comm_poll(void); 
+
+/* si_comm_set_input_function: makes input_function be called, 
+   with interrupts disabled, when input arrives. The function 
+   returns the number of tasks it has made ready. Returns nonzero 
+   if this is supported, which is the case on the Linux host. */ 
+int si_comm_set_input_function(int (*input_function)(void)); 
+
 /* si_comm_write: writes a message, defined as a 
    null-terminated string, stored in message_data. 
    Returns SI_COMM_OK if writing was ok. */ 
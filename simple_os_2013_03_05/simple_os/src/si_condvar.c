@@ -23,14 +23,17 @@
 #include "task.h"
 #include "interrupt.h"
 #include "wait_list.h"
+#include "wait_any.h"
 #include "ready_list.h"
 #include "schedule.h"
+#include "si_time.h"
+#include "time_handler.h"
 
 /* si_cv_init: intialisation of condvar cv */ 
 void si_cv_init(si_condvar *cv, si_semaphore *mutex)
 {
     cv->mutex = mutex; 
-    wait_list_reset(cv->wait_list, WAIT_LIST_SIZE); 
+    wait_list_reset(&cv->wait_list); 
 }
 
 /* si_cv_wait: wait operation on cv */
@@ -41,27 +44,32 @@ void si_cv_wait(si_condvar *cv)
     /* disable interrupts */ 
     DISABLE_INTERRUPTS; 
 
+    /* restore priority, if the mutex has a ceiling */ 
+    si_sem_clear_holder(cv->mutex); 
+
     /* check if tasks are waiting */ 
-    if (!wait_list_is_empty(
-            cv->mutex->wait_list, WAIT_LIST_SIZE))
+    if (!wait_list_is_empty(&cv->mutex->wait_list))
     {
         /* get task_id with highest priority */ 
-        task_id = wait_list_remove_highest_prio(
-            cv->mutex->wait_list, WAIT_LIST_SIZE); 
+        task_id = wait_list_remove_highest_prio(&cv->mutex->wait_list); 
+        /* the task becomes the holder of the mutex */ 
+        si_sem_set_holder(cv->mutex, task_id); 
         /* make this task ready to run */ 
         ready_list_insert(task_id); 
     }
     else
     {
-        /* increment counter */ 
+        /* increment counter, and make tasks waiting 
+           in si_wait_any ready */ 
         cv->mutex->counter++; 
+        wait_any_list_notify(&cv->mutex->wait_any_list); 
     }
     /* get task_id of running task */ 
     task_id = task_get_task_id_running();
     /* remove it from ready list */ 
     ready_list_remove(task_id); 
     /* insert it into the condvar waiting list */ 
-    wait_list_insert(cv->wait_list, WAIT_LIST_SIZE, task_id); 
+    wait_list_insert(&cv->wait_list, task_id); 
     /* call schedule */ 
     schedule(); 
 
@@ -69,6 +77,60 @@ void si_cv_wait(si_condvar *cv)
     ENABLE_INTERRUPTS; 
 }
 
+/* si_cv_wait_timed: wait operation on cv, with a timeout */
+int si_cv_wait_timed(si_condvar *cv, int timeout_ms)
+{
+    int task_id; 
+    /* the result */ 
+    int result; 
+        
+    DISABLE_INTERRUPTS; 
+
+    /* release the mutex, as in si_cv_wait */ 
+    si_sem_clear_holder(cv->mutex); 
+    if (!wait_list_is_empty(&cv->mutex->wait_list))
+    {
+        task_id = wait_list_remove_highest_prio(&cv->mutex->wait_list); 
+        si_sem_set_holder(cv->mutex, task_id); 
+        ready_list_insert(task_id); 
+    }
+    else
+    {
+        cv->mutex->counter++; 
+        wait_any_list_notify(&cv->mutex->wait_any_list); 
+    }
+
+    /* wait in the condvar waiting list, and in the time list */ 
+    task_id = task_get_task_id_running();
+    ready_list_remove(task_id); 
+    wait_list_insert(&cv->wait_list, task_id); 
+    time_handler_start_timeout(si_time_ms_to_ticks(timeout_ms)); 
+    schedule(); 
+
+    result = SI_OK; 
+    if (time_handler_has_timed_out())
+    {
+        /* the task was not moved to the mutex waiting list, 
+           by si_cv_broadcast, so the mutex is taken here */ 
+        result = SI_TIMEOUT; 
+        if (cv->mutex->counter > 0)
+        {
+            cv->mutex->counter--; 
+            si_sem_set_holder(cv->mutex, task_id); 
+        }
+        else
+        {
+            ready_list_remove(task_id); 
+            wait_list_insert(&cv->mutex->wait_list, task_id); 
+            schedule(); 
+        }
+    }
+
+    ENABLE_INTERRUPTS; 
+
+    return result; 
+}
+
 /* si_cv_broadcast: broadcast operation on cv */
 void si_cv_broadcast(si_condvar *cv)
 {
@@ -79,20 +141,16 @@ void si_cv_broadcast(si_condvar *cv)
     DISABLE_INTERRUPTS; 
 
     /* we are done if the wait list is empty */ 
-    done = wait_list_is_empty(
-               cv->wait_list, WAIT_LIST_SIZE); 
+    done = wait_list_is_empty(&cv->wait_list); 
     while (!done)
     {
         /* remove one task from the list of waiting 
            tasks */ 
-        task_id = wait_list_remove_one(
-            cv->wait_list, WAIT_LIST_SIZE); 
+        task_id = wait_list_remove_one(&cv->wait_list); 
         /* insert it into the mutex waiting list */ 
-        wait_list_insert(
-            cv->mutex->wait_list, WAIT_LIST_SIZE, task_id); 
+        wait_list_insert(&cv->mutex->wait_list, task_id); 
         /* check if we are done */ 
-        done = wait_list_is_empty(
-                   cv->wait_list, WAIT_LIST_SIZE); 
+        done = wait_list_is_empty(&cv->wait_list); 
     }
 
     /* enable interrupts */ 
@@ -22,19 +22,26 @@
 #define CONDVAR_H
 
 #include "si_semaphore.h"
+#include "wait_list.h"
 
 typedef struct 
 {
     /* the associated semaphore */ 
     si_semaphore *mutex; 
     /* the list of processes waiting for the condition variable */ 
-    int wait_list[WAIT_LIST_SIZE]; 
+    wait_list_type wait_list; 
 } si_condvar; 
 
 void si_cv_init(si_condvar *cv, si_semaphore *mutex); 
 
 void si_cv_wait(si_condvar *cv); 
 
+/* si_cv_wait_timed: wait operation on cv, where the calling 
+   task waits at most timeout_ms milliseconds for si_cv_broadcast. 
+   The mutex is held when the call returns. Returns SI_OK, or 
+   SI_TIMEOUT if the timeout expired, see si_time.h. */ 
+int si_cv_wait_timed(si_condvar *cv, int timeout_ms); 
+
 void si_cv_broadcast(si_condvar *cv); 
 
 #endif
@@ -0,0 +1,75 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+#include "si_event.h"
+
+#include "interrupt.h"
+#include "schedule.h"
+#include "si_wait.h"
+
+void si_event_init(si_event *event)
+{
+    event->bits = 0; 
+    wait_any_list_reset(&event->wait_any_list); 
+}
+
+int si_event_set_bits(si_event *event, unsigned int bits)
+{
+    event->bits |= bits; 
+    return wait_any_list_notify(&event->wait_any_list); 
+}
+
+void si_event_set(si_event *event, unsigned int bits)
+{
+    DISABLE_INTERRUPTS; 
+    if (si_event_set_bits(event, bits) > 0)
+    {
+        schedule(); 
+    }
+    ENABLE_INTERRUPTS; 
+}
+
+void si_event_clear(si_event *event, unsigned int bits)
+{
+    DISABLE_INTERRUPTS; 
+    event->bits &= ~bits; 
+    ENABLE_INTERRUPTS; 
+}
+
+unsigned int si_event_take(si_event *event, unsigned int mask)
+{
+    /* the set flags in mask */ 
+    unsigned int bits = event->bits & mask; 
+
+    event->bits &= ~bits; 
+    return bits; 
+}
+
+unsigned int si_event_wait(si_event *event, unsigned int mask)
+{
+    /* the event, as the only object to wait for */ 
+    si_wait_item item; 
+
+    item.type = SI_WAIT_EVENT; 
+    item.object = event; 
+    item.mask = mask; 
+    item.bits = 0; 
+    si_wait_any(&item, 1, SI_WAIT_FOREVER); 
+    return item.bits; 
+}
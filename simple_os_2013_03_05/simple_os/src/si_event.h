@@ -0,0 +1,59 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+#ifndef SI_EVENT_H
+#define SI_EVENT_H
+
+#include "wait_any.h"
+
+/* data type for event flags, where each bit is 
+   a flag which is set by si_event_set */ 
+typedef struct
+{
+    /* the flags which are set */ 
+    unsigned int bits; 
+    /* the list of waiting tasks */ 
+    wait_any_list_type wait_any_list; 
+} si_event; 
+
+/* si_event_init: initialises event, with no flags set */ 
+void si_event_init(si_event *event); 
+
+/* si_event_set: sets the flags in bits, and makes 
+   the tasks waiting for any of them ready */ 
+void si_event_set(si_event *event, unsigned int bits); 
+
+/* si_event_clear: clears the flags in bits */ 
+void si_event_clear(si_event *event, unsigned int bits); 
+
+/* si_event_wait: waits until any of the flags in mask is 
+   set, and clears and returns the set flags in mask */ 
+unsigned int si_event_wait(si_event *event, unsigned int mask); 
+
+/* si_event_set_bits: sets the flags in bits, as si_event_set, 
+   without calling schedule. Returns the number of tasks made 
+   ready. Called with interrupts disabled, e.g. from a function 
+   set by tick_handler_set_poll_function. */ 
+int si_event_set_bits(si_event *event, unsigned int bits); 
+
+/* si_event_take: clears and returns the set flags in mask. 
+   Called with interrupts disabled, by si_wait_any. */ 
+unsigned int si_event_take(si_event *event, unsigned int mask); 
+
+#endif
@@ -21,6 +21,7 @@
 #include "si_kernel.h"
 
 #include "tcb_storage.h"
+#include "tcb.h"
 #include "task.h"
 #include "ready_list.h"
 #include "tick_handler.h"
@@ -31,48 +32,45 @@
 #include "exceptions.h"
 #include "int_status.h"
 #include "console.h"
+#include "idle.h"
+#include "fpu.h"
+#include "smp.h"
+#include "wait_list.h"
+#include "wait_any.h"
+#include "si_mutex.h"
+#include "si_message.h"
+#include "task_id_list.h"
 
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
-
-#ifdef BUILD_X86_WIN_HOST
-
-/* Windows API include file */ 
-#include <windows.h>
-
-#else
-
-/* unistd is needed for usleep and sleep */ 
-#include <unistd.h>
-
+#include <stdlib.h>
 #endif
 
+#if SI_LATENCY_N_BUCKETS != LATENCY_N_BUCKETS
+#error "SI_LATENCY_N_BUCKETS shall be equal to LATENCY_N_BUCKETS"
 #endif
 
 /* CHANGE this string when doing new release of Simple_OS */ 
 #define SIMPLE_OS_VERSION_STRING "Simple_OS - 2013-03-05\n"
 
-/* stack for idle task */ 
+/* stack for idle task, one for each CPU */ 
 #define IDLE_STACK_SIZE 5000 
 
-static stack_item Idle_Stack[IDLE_STACK_SIZE]; 
+static stack_item Idle_Stack[SMP_N_CPUS][IDLE_STACK_SIZE]; 
 
 static int Kernel_Running; 
 
+/* the idle task, for each CPU */ 
+static int Idle_Task_Id[SMP_N_CPUS]; 
+
+/* the time when the kernel was started, for CPU accounting */ 
+static long long Kernel_Start_Ns; 
+
+#ifdef BUILD_ARM_BB
+
 /* a function which does a lot of work */ 
 static void do_work(void)
 {
-#ifdef BUILD_ARM_BB
     long max_count = 1000000; 
-#endif
-#ifdef BUILD_X86_HOST
-    long max_count = 400000000; 
-#endif
-#ifdef BUILD_X86_64_HOST
-    long max_count = 200000000; 
-#endif
-#ifdef BUILD_X86_MAC_HOST
-    long max_count = 200000000; 
-#endif
     long i; int x, y; 
     for (i = 0; i < max_count; i++)
     {
@@ -81,17 +79,6 @@ static void do_work(void)
     }
 }
 
-#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
-
-static void do_sleep(void)
-{
-#ifdef BUILD_X86_WIN_HOST
-    Sleep(10); 
-#else
-    do_work(); // usleep(10000); 
-#endif
-}
-
 #endif
 
 /* idle task */ 
@@ -102,7 +89,7 @@ static void idle_task(void)
 #ifdef BUILD_ARM_BB
         do_work(); 
 #else
-        do_sleep(); 
+        idle_wait(); 
 #endif
     }
 }
@@ -113,12 +100,25 @@ void si_kernel_init(void)
     /* task_id for idle task */ 
     int task_id_idle; 
 
+    /* loop counter */ 
+    int cpu; 
+
     /* kernel is not running yet */ 
     Kernel_Running = 0; 
 
+#ifdef SMP_HOST
+    /* the calling thread becomes CPU 0 */ 
+    smp_init(); 
+#endif
+
     /* initialise task module */ 
     task_init(); 
 
+#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
+    /* a task function which returns ends its task */ 
+    task_set_return_function(si_task_exit); 
+#endif
+
     /* initialise ready list */ 
     ready_list_init(); 
 
@@ -135,13 +135,19 @@ void si_kernel_init(void)
     /* initialise time storage */ 
     time_storage_init(); 
 
-    /* create idle task */ 
-    task_id_idle = task_create(idle_task, 
-        &Idle_Stack[IDLE_STACK_SIZE-1], 
-        IDLE_PRIORITY); 
+    /* create idle task, for each CPU */ 
+    for (cpu = 0; cpu < SMP_N_CPUS; cpu++)
+    {
+        task_id_idle = task_create_stack(idle_task, 
+            Idle_Stack[cpu], IDLE_STACK_SIZE, IDLE_PRIORITY); 
+        Idle_Task_Id[cpu] = task_id_idle; 
+#ifdef SMP_HOST
+        smp_set_idle_task(cpu, task_id_idle); 
+#endif
 
-    /* and insert it into the ready list */
-    ready_list_insert(task_id_idle); 
+        /* and insert it into the ready list */
+        ready_list_insert(task_id_idle); 
+    }
 
     int_status_init(); 
 
@@ -158,6 +164,7 @@ void si_kernel_start(void)
   
     /* the kernel is running */ 
     Kernel_Running = 1; 
+    Kernel_Start_Ns = task_get_time_ns(); 
 
     /* print version information */ 
     console_put_string(SIMPLE_OS_VERSION_STRING); 
@@ -165,15 +172,274 @@ void si_kernel_start(void)
     /* get task_id for task with highest priority */ 
     task_id_highest = ready_list_get_task_id_highest_prio(); 
 
+#ifdef SMP_HOST
+    /* start the other CPUs */ 
+    smp_start(); 
+#endif
+
     /* start the task with highest priority */ 
     task_start(task_id_highest); 
 }
 /* fig_end si_kernel_start */
 
+/* si_kernel_set_tick_mode: selects periodic 
+   or tickless mode */ 
+void si_kernel_set_tick_mode(int tick_mode)
+{
+    /* disable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        DISABLE_INTERRUPTS; 
+    }
+
+    tick_handler_set_tickless(tick_mode == SI_TICK_MODE_TICKLESS); 
+
+    /* enable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        ENABLE_INTERRUPTS; 
+    }
+}
+
+/* si_kernel_set_tick_rate: sets the tick rate */ 
+int si_kernel_set_tick_rate(int n_ticks_per_sec)
+{
+    /* the result from tick_handler_set_tick_rate */ 
+    int result; 
+
+    /* disable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        DISABLE_INTERRUPTS; 
+    }
+
+    result = tick_handler_set_tick_rate(n_ticks_per_sec); 
+
+    /* enable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        ENABLE_INTERRUPTS; 
+    }
+
+    return result; 
+}
+
+/* si_kernel_set_time_slice: sets the time quantum 
+   for a priority */ 
+void si_kernel_set_time_slice(int priority, int n_ms)
+{
+    /* number of microseconds per tick */ 
+    long n_us_per_tick; 
+
+    /* disable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        DISABLE_INTERRUPTS; 
+    }
+
+    n_us_per_tick = time_storage_get_us_per_tick(); 
+    tick_handler_set_time_slice(priority, 
+        (int) ((n_ms * 1000LL + n_us_per_tick - 1) / n_us_per_tick)); 
+
+    /* enable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        ENABLE_INTERRUPTS; 
+    }
+}
+
+/* si_kernel_get_idle_time: returns the idle time */ 
+void si_kernel_get_idle_time(si_time *idle_time)
+{
+    /* the idle time in milliseconds */ 
+    long long idle_ms; 
+
+    /* disable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        DISABLE_INTERRUPTS; 
+    }
+
+    idle_ms = idle_get_time_us() / 1000; 
+    si_time_set(idle_time, (int) (idle_ms / 1000), (int) (idle_ms % 1000)); 
+
+    /* enable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        ENABLE_INTERRUPTS; 
+    }
+}
+
+/* is_idle_task: returns nonzero if task_id is an idle task */ 
+static int is_idle_task(int task_id)
+{
+    int cpu; 
+    for (cpu = 0; cpu < SMP_N_CPUS; cpu++)
+    {
+        if (Idle_Task_Id[cpu] == task_id)
+        {
+            return 1; 
+        }
+    }
+    return 0; 
+}
+
+/* percent: returns part in percent of total */ 
+static int percent(long long part, long long total)
+{
+    if (total <= 0)
+    {
+        return 0; 
+    }
+    return (int) (part * 100 / total); 
+}
+
+/* si_kernel_get_stats: returns the CPU usage for the kernel */ 
+void si_kernel_get_stats(si_kernel_stats *stats)
+{
+    /* the current time */ 
+    long long now_ns; 
+    /* the elapsed time, and the idle time */ 
+    long long elapsed_ns; 
+    long long idle_ns = 0; 
+    /* loop counters */ 
+    int cpu; 
+    int task_id; 
+
+    DISABLE_INTERRUPTS; 
+
+    now_ns = task_get_time_ns(); 
+    elapsed_ns = now_ns - Kernel_Start_Ns; 
+    for (cpu = 0; cpu < SMP_N_CPUS; cpu++)
+    {
+        idle_ns += task_get_run_time_ns(Idle_Task_Id[cpu], now_ns); 
+    }
+    stats->elapsed_us = elapsed_ns / 1000; 
+    stats->idle_us = idle_ns / 1000; 
+    stats->idle_percent = percent(idle_ns, elapsed_ns * SMP_N_CPUS); 
+    stats->n_switches = task_get_n_switches(); 
+    stats->n_tasks = 0; 
+    for (task_id = 0; task_id < tcb_storage_get_tcb_list_size(); task_id++)
+    {
+        if (tcb_is_valid(tcb_storage_get_tcb_ref(task_id)))
+        {
+            stats->n_tasks++; 
+        }
+    }
+
+    ENABLE_INTERRUPTS; 
+}
+
+/* si_task_get_stats: returns the CPU usage for task_id */ 
+int si_task_get_stats(int task_id, si_task_stats *stats)
+{
+    /* a pointer to the TCB for task_id */ 
+    task_control_block *tcb_ref; 
+    /* the current time */ 
+    long long now_ns; 
+    /* the run time */ 
+    long long run_time_ns; 
+
+    if (task_id < 0 || task_id >= tcb_storage_get_tcb_list_size())
+    {
+        return -1; 
+    }
+
+    DISABLE_INTERRUPTS; 
+
+    tcb_ref = tcb_storage_get_tcb_ref(task_id); 
+    if (!tcb_is_valid(tcb_ref))
+    {
+        ENABLE_INTERRUPTS; 
+        return -1; 
+    }
+    now_ns = task_get_time_ns(); 
+    run_time_ns = task_get_run_time_ns(task_id, now_ns); 
+    stats->priority = tcb_ref->priority; 
+    stats->is_idle = is_idle_task(task_id); 
+    stats->run_time_us = run_time_ns / 1000; 
+    stats->run_percent = percent(run_time_ns, now_ns - Kernel_Start_Ns); 
+    stats->n_switches = tcb_ref->n_switches; 
+    stats->n_voluntary = tcb_ref->n_voluntary; 
+    stats->n_preempted = tcb_ref->n_preempted; 
+
+    ENABLE_INTERRUPTS; 
+
+    return 0; 
+}
+
+/* latency_percentile_us: returns the upper limit, in microseconds, 
+   of the histogram bucket in *tcb_ref where percent of the 
+   latencies are found, limited by the maximum latency */ 
+static long latency_percentile_us(task_control_block *tcb_ref, int percent)
+{
+    /* the maximum latency, in microseconds */ 
+    long max_us = (long) (tcb_ref->max_latency_ns / 1000); 
+    /* the number of latencies up to the current bucket */ 
+    long long n_below = 0; 
+    /* the upper limit of the current bucket */ 
+    long limit_us = 1; 
+
+    int bucket; 
+
+    for (bucket = 0; bucket < LATENCY_N_BUCKETS - 1; bucket++)
+    {
+        n_below += tcb_ref->latency_histogram[bucket]; 
+        if (n_below * 100 >= (long long) percent * tcb_ref->n_latencies)
+        {
+            return limit_us < max_us ? limit_us : max_us; 
+        }
+        limit_us <<= 1; 
+    }
+    return max_us; 
+}
+
+/* si_task_get_latency_stats: returns the wakeup latency for task_id */ 
+int si_task_get_latency_stats(int task_id, si_latency_stats *stats)
+{
+    /* a pointer to the TCB for task_id */ 
+    task_control_block *tcb_ref; 
+
+    int i; 
+
+    if (task_id < 0 || task_id >= tcb_storage_get_tcb_list_size())
+    {
+        return -1; 
+    }
+
+    DISABLE_INTERRUPTS; 
+
+    tcb_ref = tcb_storage_get_tcb_ref(task_id); 
+    if (!tcb_is_valid(tcb_ref))
+    {
+        ENABLE_INTERRUPTS; 
+        return -1; 
+    }
+    stats->n_samples = tcb_ref->n_latencies; 
+    stats->mean_us = 0; 
+    if (tcb_ref->n_latencies > 0)
+    {
+        stats->mean_us = (long) (tcb_ref->sum_latency_ns / 
+            tcb_ref->n_latencies / 1000); 
+    }
+    stats->max_us = (long) (tcb_ref->max_latency_ns / 1000); 
+    stats->p50_us = latency_percentile_us(tcb_ref, 50); 
+    stats->p90_us = latency_percentile_us(tcb_ref, 90); 
+    stats->p99_us = latency_percentile_us(tcb_ref, 99); 
+    for (i = 0; i < SI_LATENCY_N_BUCKETS; i++)
+    {
+        stats->histogram[i] = tcb_ref->latency_histogram[i]; 
+    }
+
+    ENABLE_INTERRUPTS; 
+
+    return 0; 
+}
+
 /* si_task_create: create a task from the 
    function pf, with stack starting at stack_bottom, 
    and having priority priority. */ 
-void si_task_create(
+int si_task_create(
     void (*task_function)(void), 
     stack_item *stack_bottom, int priority)
 {
@@ -190,7 +456,45 @@ void si_task_create(
     task_id = task_create(task_function, stack_bottom, priority); 
 
     /* and insert it into ready list */ 
-    ready_list_insert(task_id); 
+    if (task_id != TASK_ID_INVALID)
+    {
+        ready_list_insert(task_id); 
+    }
+
+    /* call schedule and enable interrupts if kernel 
+       is running */ 
+    if (Kernel_Running)
+    {
+        schedule(); 
+        ENABLE_INTERRUPTS; 
+    }
+
+    return task_id; 
+}
+
+/* si_task_create_stack: create a task from the function 
+   task_function, with the stack stack of size stack_size */ 
+int si_task_create_stack(
+    void (*task_function)(void), 
+    stack_item stack[], int stack_size, int priority)
+{
+    /* task_id for created task */ 
+    int task_id; 
+
+    /* disable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        DISABLE_INTERRUPTS; 
+    }
+
+    /* create the task */ 
+    task_id = task_create_stack(task_function, stack, stack_size, priority); 
+
+    /* and insert it into ready list */ 
+    if (task_id != TASK_ID_INVALID)
+    {
+        ready_list_insert(task_id); 
+    }
 
     /* call schedule and enable interrupts if kernel 
        is running */ 
@@ -199,5 +503,198 @@ void si_task_create(
         schedule(); 
         ENABLE_INTERRUPTS; 
     }
+
+    return task_id; 
+}
+
+/* si_task_create_auto: create a task from the function 
+   task_function, with a stack allocated by the kernel */ 
+int si_task_create_auto(
+    void (*task_function)(void), int stack_size, int priority)
+{
+    /* task_id for created task */ 
+    int task_id; 
+
+    /* disable interrupts if kernel is running */ 
+    if (Kernel_Running)
+    {
+        DISABLE_INTERRUPTS; 
+    }
+
+    /* create the task */ 
+    task_id = task_create_auto(task_function, stack_size, priority); 
+
+    /* and insert it into ready list */ 
+    if (task_id != TASK_ID_INVALID)
+    {
+        ready_list_insert(task_id); 
+    }
+
+    /* call schedule and enable interrupts if kernel 
+       is running */ 
+    if (Kernel_Running)
+    {
+        schedule(); 
+        ENABLE_INTERRUPTS; 
+    }
+
+    return task_id; 
+}
+
+/* remove_task: removes task_id from all lists where it may 
+   be stored. Returns 0, or -1 if task_id holds a mutex or a 
+   semaphore with ceiling, and thus cannot be removed. */ 
+static int remove_task(int task_id)
+{
+    /* a pointer to the TCB for task_id */ 
+    task_control_block *tcb_ref = tcb_storage_get_tcb_ref(task_id); 
+    /* the owner of the mutex which task_id waits for */ 
+    int owner_task_id; 
+
+    if (tcb_ref->held_mutexes != 0 || tcb_ref->held_ceiling_sems != 0)
+    {
+        return -1; 
+    }
+    if (tcb_ref->is_ready)
+    {
+        ready_list_remove(task_id); 
+    }
+    if (tcb_ref->is_timed)
+    {
+        time_list_remove(task_id); 
+    }
+    if (tcb_ref->wait_list != 0)
+    {
+        wait_list_remove(tcb_ref->wait_list, task_id); 
+    }
+    if (tcb_ref->wait_any_nodes != 0)
+    {
+        wait_any_remove_nodes(task_id); 
+    }
+    if (tcb_ref->waiting_mutex != 0)
+    {
+        /* the owner no longer inherits the priority of task_id */ 
+        owner_task_id = tcb_ref->waiting_mutex->owner_task_id; 
+        tcb_ref->waiting_mutex = 0; 
+        si_mutex_restore_priority(owner_task_id); 
+    }
+    si_message_reset_task(task_id); 
+    return 0; 
+}
+
+/* si_task_exit: ends the calling task */ 
+void si_task_exit(void)
+{
+    /* the calling task */ 
+    int task_id; 
+
+    DISABLE_INTERRUPTS; 
+
+    task_id = task_get_task_id_running(); 
+    if (remove_task(task_id) != 0)
+    {
+        console_put_string("Simple_OS: task holding a mutex or ceiling exits "); 
+        console_put_hex(task_id); 
+        console_put_string("\n"); 
+        /* stop, since the mutex or semaphore would never be released */ 
+#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
+        exit(1); 
+#else
+        while (1)
+        {
+        }
+#endif
+    }
+    /* the TCB and the stack are freed when another task runs */ 
+    task_delete(task_id); 
+    schedule(); 
+}
+
+/* si_task_delete: deletes task_id */ 
+int si_task_delete(int task_id)
+{
+    if (task_id < 0 || task_id >= tcb_storage_get_tcb_list_size())
+    {
+        return -1; 
+    }
+
+    DISABLE_INTERRUPTS; 
+
+    if (!tcb_is_valid(tcb_storage_get_tcb_ref(task_id)) || 
+        tcb_storage_get_tcb_ref(task_id)->has_exited || 
+        is_idle_task(task_id) || 
+        (task_is_running(task_id) && 
+         task_id != task_get_task_id_running()))
+    {
+        ENABLE_INTERRUPTS; 
+        return -1; 
+    }
+    if (task_id == task_get_task_id_running())
+    {
+        ENABLE_INTERRUPTS; 
+        si_task_exit(); 
+    }
+    if (remove_task(task_id) != 0)
+    {
+        ENABLE_INTERRUPTS; 
+        return -1; 
+    }
+    task_delete(task_id); 
+    task_reap(); 
+
+    /* tasks waiting to send to task_id, or a mutex owner, 
+       may have changed */ 
+    if (Kernel_Running)
+    {
+        schedule(); 
+    }
+
+    ENABLE_INTERRUPTS; 
+
+    return 0; 
 }
 
+/* si_task_get_stack_stats: returns the stack usage for task_id */ 
+int si_task_get_stack_stats(int task_id, si_stack_stats *stats)
+{
+    /* the largest stack usage */ 
+    int max_used; 
+
+    if (task_id < 0 || task_id >= tcb_storage_get_tcb_list_size())
+    {
+        return -1; 
+    }
+
+    DISABLE_INTERRUPTS; 
+
+    max_used = -1; 
+    if (tcb_is_valid(tcb_storage_get_tcb_ref(task_id)))
+    {
+        max_used = task_get_stack_used(task_id); 
+        stats->stack_size = tcb_storage_get_tcb_ref(task_id)->stack_size; 
+        stats->max_used = max_used; 
+    }
+
+    ENABLE_INTERRUPTS; 
+
+    return max_used < 0 ? -1 : 0; 
+}
+
+/* si_task_get_id: returns the task id of the calling task */ 
+int si_task_get_id(void)
+{
+    return task_get_task_id_running(); 
+}
+
+/* si_task_use_fpu: gives the calling task a private FPU context */ 
+int si_task_use_fpu(void)
+{
+    /* the result from fpu_task_use */ 
+    int result; 
+
+    DISABLE_INTERRUPTS; 
+    result = fpu_task_use(task_get_task_id_running()); 
+    ENABLE_INTERRUPTS; 
+
+    return result; 
+}
@@ -22,6 +22,7 @@
 #define SI_KERNEL_H
 
 #include "arch_types.h"
+#include "si_time_type.h"
 
 #define IDLE_PRIORITY 1000
 
@@ -31,11 +32,189 @@ void si_kernel_init(void);
 /* si_kernel_start: start real-time kernel */ 
 void si_kernel_start(void); 
 
+/* tick modes, for si_kernel_set_tick_mode */ 
+#define SI_TICK_MODE_PERIODIC 0
+#define SI_TICK_MODE_TICKLESS 1
+
+/* si_kernel_set_tick_mode: selects how time is kept. In 
+   SI_TICK_MODE_PERIODIC, which is the default, the timer 
+   interrupts periodically. In SI_TICK_MODE_TICKLESS, the 
+   timer interrupts only when a waiting time expires. 
+   Tickless mode is available on the Linux host. */ 
+void si_kernel_set_tick_mode(int tick_mode); 
+
+/* si_kernel_set_tick_rate: sets the number of timer ticks 
+   per second, from 50 to 10000, which is the resolution of 
+   waiting times. The rate shall divide 1000000, so that a 
+   tick is a whole number of microseconds. The default is 50. 
+   The tick rate can be selected on the Linux host. Shall be 
+   called before any task waits for time to expire. Returns 0, 
+   or -1 if the rate is not accepted, and then is unchanged. */ 
+int si_kernel_set_tick_rate(int n_ticks_per_sec); 
+
+/* si_kernel_set_time_slice: sets the time quantum, in 
+   milliseconds, for tasks with priority priority, so that 
+   ready tasks with the same priority take turns to run. 
+   A quantum of 0, which is the default, means that a task 
+   runs until it waits or is preempted. The quantum is 
+   rounded up to whole ticks, and the tick rate shall 
+   therefore be set first. */ 
+void si_kernel_set_time_slice(int priority, int n_ms); 
+
+/* si_kernel_get_idle_time: returns, in *idle_time, the 
+   total time during which the host process has slept 
+   in the idle task. Idle time is accounted on the 
+   Linux host. */ 
+void si_kernel_get_idle_time(si_time *idle_time); 
+
+/* CPU usage for the kernel, as returned by si_kernel_get_stats */ 
+typedef struct
+{
+    /* time since the kernel was started, in microseconds */ 
+    long long elapsed_us; 
+    /* time during which the idle task has run, in microseconds. 
+       With several CPUs, the idle tasks of all CPUs are counted. */ 
+    long long idle_us; 
+    /* idle time in percent of the available CPU time */ 
+    int idle_percent; 
+    /* total number of task switches */ 
+    long n_switches; 
+    /* number of created tasks, including idle tasks */ 
+    int n_tasks; 
+} si_kernel_stats; 
+
+/* CPU usage for a task, as returned by si_task_get_stats */ 
+typedef struct
+{
+    /* the current priority */ 
+    int priority; 
+    /* nonzero for an idle task */ 
+    int is_idle; 
+    /* time during which the task has run, in microseconds */ 
+    long long run_time_us; 
+    /* run time in percent of the elapsed time */ 
+    int run_percent; 
+    /* number of times the task has started running */ 
+    int n_switches; 
+    /* number of times the task stopped running since it 
+       waited, and since it was preempted */ 
+    int n_voluntary; 
+    int n_preempted; 
+} si_task_stats; 
+
+/* number of buckets in si_latency_stats. Bucket 0 counts 
+   latencies below 1 microsecond, bucket i, for 0 < i < 
+   SI_LATENCY_N_BUCKETS-1, counts latencies from 2^(i-1) 
+   up to 2^i microseconds, and the last bucket counts 
+   latencies of 2^(SI_LATENCY_N_BUCKETS-2) microseconds 
+   or more */ 
+#define SI_LATENCY_N_BUCKETS 24
+
+/* wakeup latency for a task, as returned by 
+   si_task_get_latency_stats. The latency is the time from 
+   when the task becomes ready, e.g. when a semaphore is 
+   signalled, a message arrives or a waiting time expires, 
+   until the task runs. */ 
+typedef struct
+{
+    /* number of measured latencies */ 
+    int n_samples; 
+    /* mean and maximum latency, in microseconds */ 
+    long mean_us; 
+    long max_us; 
+    /* percentiles, in microseconds, as the upper limit of 
+       the histogram bucket where the percentile is found */ 
+    long p50_us; 
+    long p90_us; 
+    long p99_us; 
+    /* number of latencies in each bucket */ 
+    unsigned int histogram[SI_LATENCY_N_BUCKETS]; 
+} si_latency_stats; 
+
+/* si_kernel_get_stats: returns, in *stats, the CPU usage 
+   since the kernel was started. Run times are measured on 
+   each task switch, on the Linux host. */ 
+void si_kernel_get_stats(si_kernel_stats *stats); 
+
+/* si_task_get_stats: returns, in *stats, the CPU usage 
+   for task task_id. Returns 0, or -1 if task_id is not 
+   the id of a created task. */ 
+int si_task_get_stats(int task_id, si_task_stats *stats); 
+
+/* si_task_get_latency_stats: returns, in *stats, the wakeup 
+   latency for task task_id. Latencies are measured on the 
+   Linux host. Returns 0, or -1 if task_id is not the id 
+   of a created task. */ 
+int si_task_get_latency_stats(int task_id, si_latency_stats *stats); 
+
 /* si_task_create: create a task from the 
    function task_function, with stack starting at stack_bottom, 
-   and having priority priority. */ 
-void si_task_create(
+   and having priority priority. Returns the task id of 
+   the created task, or -1 if no task id is available. */ 
+int si_task_create(
     void (*task_function)(void), 
     stack_item *stack_bottom, int priority); 
 
+/* si_task_create_stack: create a task as si_task_create, with 
+   the stack stack, which has stack_size stack items. Overflow 
+   of the stack is detected, using a canary at the end of the 
+   stack, each time the task stops running, and the largest 
+   stack usage is returned by si_task_get_stack_stats. Returns 
+   the task id of the created task, or -1 if no task id is 
+   available. */ 
+int si_task_create_stack(
+    void (*task_function)(void), 
+    stack_item stack[], int stack_size, int priority); 
+
+/* si_task_create_auto: create a task as si_task_create, with 
+   a stack of at least stack_size stack items, which is allocated 
+   by the kernel. On the Linux host, the stack is preceded by a 
+   guard page, so that an overflow causes a segmentation fault. 
+   The stack is checked as for si_task_create_stack. The task 
+   id and the stack are reused when the task has been deleted. 
+   Returns the task id of the created task, or -1 if no task id 
+   or stack is available. */ 
+int si_task_create_auto(
+    void (*task_function)(void), int stack_size, int priority); 
+
+/* si_task_exit: ends the calling task, which is deleted. On 
+   the host, a task function which returns calls si_task_exit. */ 
+void si_task_exit(void); 
+
+/* si_task_delete: deletes task task_id, which is removed from 
+   the ready list, and from the time list or any list of tasks 
+   waiting for a semaphore, mutex, event or message. Messages 
+   sent to the task are discarded. If task_id is the calling 
+   task, si_task_delete does not return. Returns 0, or -1 if 
+   task_id is not the id of a created task, is an idle task, 
+   holds a mutex or a semaphore with ceiling, or is running on 
+   another CPU. */ 
+int si_task_delete(int task_id); 
+
+/* stack usage for a task, as returned by si_task_get_stack_stats */ 
+typedef struct
+{
+    /* the stack size, in stack items */ 
+    int stack_size; 
+    /* the largest number of stack items used, or the stack 
+       size if the stack has overflowed */ 
+    int max_used; 
+} si_stack_stats; 
+
+/* si_task_get_stack_stats: returns, in *stats, the stack usage 
+   for task task_id. Returns 0, or -1 if task_id is not the id 
+   of a task created by si_task_create_stack or 
+   si_task_create_auto. */ 
+int si_task_get_stack_stats(int task_id, si_stack_stats *stats); 
+
+/* si_task_get_id: returns the task id of the calling task */ 
+int si_task_get_id(void); 
+
+/* si_task_use_fpu: gives the calling task a private FPU 
+   context, so that its floating point state, e.g. rounding 
+   modes, is not changed by other tasks. Tasks which do not 
+   call si_task_use_fpu shall use integer arithmetic only. 
+   Returns 0, or -1 if no FPU context is available. */ 
+int si_task_use_fpu(void); 
+
 #endif
@@ -25,46 +25,627 @@
 #include "tcb_storage.h"
 #include "interrupt.h"
 #include "task.h"
+#include "si_pool.h"
+#include "task_id_list.h"
+#include "console.h"
+#include "si_time.h"
+#include "time_handler.h"
+#include "tcb.h"
+#include "wait_list.h"
+#include "ready_list.h"
+#include "schedule.h"
+#include "wait_any.h"
 
-/* message data for each TCB */ 
-static tcb_message_type TCB_Message_List[TCB_LIST_SIZE]; 
+/* the mailbox for each task, or 0 */ 
+static tcb_message_type *Mailbox[TCB_LIST_SIZE]; 
+
+/* the mailboxes */ 
+static si_pool_item Mailbox_Memory[
+    SI_POOL_N_ITEMS(sizeof(tcb_message_type), SI_MESSAGE_N_MAILBOXES)]; 
+static si_pool Mailbox_Pool; 
+
+/* the buffered messages, with small and large contents */ 
+static si_pool_item Small_Memory[SI_POOL_N_ITEMS(
+    TASK_MESSAGE_SIZE(SI_MESSAGE_SMALL_SIZE), SI_MESSAGE_N_SMALL)]; 
+static si_pool Small_Pool; 
+static si_pool_item Large_Memory[SI_POOL_N_ITEMS(
+    TASK_MESSAGE_SIZE(MESSAGE_LENGTH), SI_MESSAGE_N_LARGE)]; 
+static si_pool Large_Pool; 
+
+#if SI_MESSAGE_BLOCK_SIZE < MESSAGE_LENGTH
+#error "SI_MESSAGE_BLOCK_SIZE shall be at least MESSAGE_LENGTH"
+#endif
+
+/* the blocks for messages passed without copying */ 
+static si_pool_item Message_Memory[
+    SI_POOL_N_ITEMS(SI_MESSAGE_BLOCK_SIZE, SI_MESSAGE_N_BLOCKS)]; 
+static si_pool Message_Pool; 
 
 /* si_message_init: initialisation of message 
    handling */ 
 void si_message_init(void)
 {
     int i; 
+    si_pool_init(&Mailbox_Pool, Mailbox_Memory, 
+        sizeof(tcb_message_type), SI_MESSAGE_N_MAILBOXES); 
+    si_pool_init(&Small_Pool, Small_Memory, 
+        TASK_MESSAGE_SIZE(SI_MESSAGE_SMALL_SIZE), SI_MESSAGE_N_SMALL); 
+    si_pool_init(&Large_Pool, Large_Memory, 
+        TASK_MESSAGE_SIZE(MESSAGE_LENGTH), SI_MESSAGE_N_LARGE); 
+    si_pool_init(&Message_Pool, Message_Memory, 
+        SI_MESSAGE_BLOCK_SIZE, SI_MESSAGE_N_BLOCKS); 
     for (i = 0; i < TCB_LIST_SIZE; i++)
     {
-        tcb_message_init(&TCB_Message_List[i]); 
-        tcb_message_set_receive_task_id(&TCB_Message_List[i], i); 
+        Mailbox[i] = 0; 
     }
 }
 
-void si_message_send(
-    const char message[], int length, int receive_task_id)
+/* message_pool: returns the pool for a buffered 
+   message with length bytes of copied contents */ 
+static si_pool *message_pool(int length)
+{
+    return length <= SI_MESSAGE_SMALL_SIZE ? &Small_Pool : &Large_Pool; 
+}
+
+/* free_message: frees message, and its block, if any. 
+   Called with interrupts disabled. */ 
+static void free_message(task_message_type *message)
+{
+    if (message->block != 0)
+    {
+        si_pool_put_block(&Message_Pool, message->block); 
+        si_pool_put_block(message_pool(0), message); 
+    }
+    else
+    {
+        si_pool_put_block(message_pool(message->length), message); 
+    }
+}
+
+/* get_mailbox: returns the mailbox of task_id, which is 
+   created if needed, or 0 if all mailboxes are used. 
+   Called with interrupts disabled. */ 
+static tcb_message_type *get_mailbox(int task_id)
+{
+    if (Mailbox[task_id] == 0)
+    {
+        Mailbox[task_id] = si_pool_take_block(&Mailbox_Pool); 
+        if (Mailbox[task_id] == 0)
+        {
+            console_put_string("si_message: no mailbox for task "); 
+            console_put_hex(task_id); 
+            console_put_string("\n"); 
+            return 0; 
+        }
+        tcb_message_init(Mailbox[task_id], SI_MESSAGE_DEFAULT_DEPTH); 
+        tcb_message_set_receive_task_id(Mailbox[task_id], task_id); 
+    }
+    return Mailbox[task_id]; 
+}
+
+int si_message_set_depth(int task_id, int depth)
+{
+    tcb_message_type* tcb_message; 
+
+    if (depth < 1 || task_id < 0 || task_id >= TCB_LIST_SIZE)
+    {
+        return -1; 
+    }
+    DISABLE_INTERRUPTS; 
+    tcb_message = get_mailbox(task_id); 
+    if (tcb_message != 0)
+    {
+        tcb_message->depth = depth; 
+    }
+    ENABLE_INTERRUPTS; 
+
+    return tcb_message != 0 ? 0 : -1; 
+}
+
+void si_message_reset_task(int task_id)
+{
+    tcb_message_type *tcb_message = Mailbox[task_id]; 
+    task_message_type *message; 
+
+    if (tcb_message == 0)
+    {
+        return; 
+    }
+    Mailbox[task_id] = 0; 
+
+    /* free the buffered messages */ 
+    while ((message = tcb_message_remove(tcb_message)) != 0)
+    {
+        free_message(message); 
+    }
+
+    /* the mailbox is freed by the last sending task which waits */ 
+    tcb_message_close(tcb_message); 
+    if (tcb_message->n_send_waiting == 0)
+    {
+        si_pool_put_block(&Mailbox_Pool, tcb_message); 
+    }
+}
+
+/* alloc_message: returns a buffered message from pool, 
+   waiting at most n_ticks ticks for a free message if needed. 
+   Returns 0 if there is no free message. Called with 
+   interrupts disabled. */ 
+static task_message_type *alloc_message(si_pool *pool, int n_ticks)
+{
+    return si_pool_wait_block(pool, n_ticks); 
+}
+
+/* send_message: adds message, from the calling task, to the 
+   mailbox of receive_task_id, waiting at most n_ticks ticks 
+   if the mailbox is full. Returns 0, or -1 if the message 
+   was not added, and thus was freed. Called with interrupts 
+   disabled. */ 
+static int send_message(
+    task_message_type *message, int receive_task_id, int n_ticks)
+{
+    tcb_message_type* tcb_message; 
+
+    tcb_message = get_mailbox(receive_task_id); 
+    if (tcb_message == 0)
+    {
+        free_message(message); 
+        return -1; 
+    }
+    if (tcb_message_write(
+            tcb_message, message, message->send_task_id, n_ticks) != 0)
+    {
+        free_message(message); 
+        /* free the mailbox, if closed, when no task uses it */ 
+        if (tcb_message->receive_task_id == TASK_ID_INVALID && 
+            tcb_message->n_send_waiting == 0)
+        {
+            si_pool_put_block(&Mailbox_Pool, tcb_message); 
+        }
+        return -1; 
+    }
+    return 0; 
+}
+
+/* receive_message: returns the oldest message for the calling 
+   task, waiting at most n_ticks ticks, or 0 if there is no 
+   message. Called with interrupts disabled. */ 
+static task_message_type *receive_message(int n_ticks)
 {
     tcb_message_type* tcb_message; 
-    int send_task_id; 
+
+    tcb_message = get_mailbox(task_get_task_id_running()); 
+    return tcb_message != 0 ? tcb_message_read(tcb_message, n_ticks) : 0; 
+}
+
+/* limit_priority: returns priority, limited to the range 
+   0 .. SI_MESSAGE_N_PRIORITIES-1 */ 
+static int limit_priority(int priority)
+{
+    if (priority < 0)
+    {
+        return 0; 
+    }
+    if (priority > SI_MESSAGE_N_PRIORITIES - 1)
+    {
+        return SI_MESSAGE_N_PRIORITIES - 1; 
+    }
+    return priority; 
+}
+
+/* send: sends message, as si_message_send_prio, waiting at most 
+   n_ticks ticks. Returns 0, or -1 if the message was not sent. */ 
+static int send(
+    const char message[], int length, int receive_task_id, 
+    int priority, int n_ticks)
+{
+    task_message_type *task_message; 
+    int result; 
+    /* the tick at which the timeout expires */ 
+    unsigned int expiry_tick = 0; 
+
+    if (length > MESSAGE_LENGTH)
+    {
+        length = MESSAGE_LENGTH; 
+    }
+    if (length < 0)
+    {
+        length = 0; 
+    }
+    DISABLE_INTERRUPTS; 
+    result = -1; 
+    if (n_ticks > 0)
+    {
+        expiry_tick = time_handler_get_expiry_tick(n_ticks); 
+    }
+    task_message = alloc_message(message_pool(length), n_ticks); 
+    if (task_message != 0)
+    {
+        /* the time spent waiting for a free message 
+           is part of the timeout */ 
+        if (n_ticks > 0)
+        {
+            n_ticks = time_handler_get_ticks_left(expiry_tick); 
+        }
+        message_write(task_message, message, length, task_get_task_id_running()); 
+        task_message->priority = limit_priority(priority); 
+        result = send_message(task_message, receive_task_id, n_ticks); 
+    }
+    ENABLE_INTERRUPTS; 
+
+    return result; 
+}
+
+/* receive: receives a message, as si_message_receive, waiting 
+   at most n_ticks ticks. Returns 0, or -1 if there was no message. */ 
+static int receive(
+    char message[], int *length, int *send_task_id, int n_ticks)
+{
+    /* the received message */ 
+    task_message_type *task_message; 
+    int i; 
 
     DISABLE_INTERRUPTS; 
-    send_task_id = task_get_task_id_running(); 
-    tcb_message = &TCB_Message_List[receive_task_id]; 
-    tcb_message_write(tcb_message, message, length, send_task_id); 
+    task_message = receive_message(n_ticks); 
+    if (task_message == 0)
+    {
+        *length = 0; 
+        *send_task_id = TASK_ID_INVALID; 
+    }
+    else if (task_message->block == 0)
+    {
+        message_read(task_message, message, length, send_task_id); 
+        free_message(task_message); 
+    }
+    else
+    {
+        /* copy the contents of the block */ 
+        *length = task_message->length; 
+        *send_task_id = task_message->send_task_id; 
+        if (*length > MESSAGE_LENGTH)
+        {
+            *length = MESSAGE_LENGTH; 
+        }
+        for (i = 0; i < *length; i++)
+        {
+            message[i] = ((char *) task_message->block)[i]; 
+        }
+        free_message(task_message); 
+    }
     ENABLE_INTERRUPTS; 
+
+    return task_message != 0 ? 0 : -1; 
 }
 
+void si_message_send(
+    const char message[], int length, int receive_task_id)
+{
+    send(message, length, receive_task_id, 
+         SI_MESSAGE_DEFAULT_PRIORITY, TIME_HANDLER_WAIT_FOREVER); 
+}
+
+void si_message_send_prio(
+    const char message[], int length, int receive_task_id, int priority)
+{
+    send(message, length, receive_task_id, 
+         priority, TIME_HANDLER_WAIT_FOREVER); 
+}
+
+int si_message_send_timed(
+    const char message[], int length, int receive_task_id, int timeout_ms)
+{
+    if (timeout_ms <= 0)
+    {
+        return si_message_try_send(message, length, receive_task_id) == SI_OK ? 
+            SI_OK : SI_TIMEOUT; 
+    }
+    return send(message, length, receive_task_id, SI_MESSAGE_DEFAULT_PRIORITY, 
+                si_time_ms_to_ticks(timeout_ms)) == 0 ? SI_OK : SI_TIMEOUT; 
+}
+
+int si_message_try_send(
+    const char message[], int length, int receive_task_id)
+{
+    return send(message, length, receive_task_id, 
+                SI_MESSAGE_DEFAULT_PRIORITY, 0) == 0 ? 
+        SI_OK : SI_WOULD_BLOCK; 
+}
 
 void si_message_receive(
     char message[], int *length, int *send_task_id)
 {
-    tcb_message_type* tcb_message; 
-    int receive_task_id; 
+    receive(message, length, send_task_id, TIME_HANDLER_WAIT_FOREVER); 
+}
+
+int si_message_receive_timed(
+    char message[], int *length, int *send_task_id, int timeout_ms)
+{
+    if (timeout_ms <= 0)
+    {
+        return si_message_try_receive(message, length, send_task_id) == SI_OK ? 
+            SI_OK : SI_TIMEOUT; 
+    }
+    return receive(message, length, send_task_id, 
+                   si_time_ms_to_ticks(timeout_ms)) == 0 ? SI_OK : SI_TIMEOUT; 
+}
+
+int si_message_try_receive(
+    char message[], int *length, int *send_task_id)
+{
+    return receive(message, length, send_task_id, 0) == 0 ? 
+        SI_OK : SI_WOULD_BLOCK; 
+}
+
+void *si_message_alloc(void)
+{
+    return si_pool_alloc(&Message_Pool); 
+}
+
+void si_message_free(void *block)
+{
+    si_pool_free(&Message_Pool, block); 
+}
+
+void si_message_send_block(void *block, int length, int receive_task_id)
+{
+    si_message_send_block_prio(
+        block, length, receive_task_id, SI_MESSAGE_DEFAULT_PRIORITY); 
+}
+
+void si_message_send_block_prio(
+    void *block, int length, int receive_task_id, int priority)
+{
+    task_message_type *task_message; 
+
+    DISABLE_INTERRUPTS; 
+    task_message = alloc_message(message_pool(0), TIME_HANDLER_WAIT_FOREVER); 
+    message_write_block(task_message, block, length, task_get_task_id_running()); 
+    task_message->priority = limit_priority(priority); 
+    send_message(task_message, receive_task_id, TIME_HANDLER_WAIT_FOREVER); 
+    ENABLE_INTERRUPTS; 
+}
+
+void *si_message_receive_block(int *length, int *send_task_id)
+{
+    /* the received message */ 
+    task_message_type *task_message; 
+    /* the block of the received message */ 
+    void *block; 
+    /* the contents of a message sent by si_message_send */ 
+    char message[MESSAGE_LENGTH]; 
+    int i; 
 
     DISABLE_INTERRUPTS; 
-    receive_task_id = task_get_task_id_running(); 
-    tcb_message = &TCB_Message_List[receive_task_id]; 
-    tcb_message_read(tcb_message, message, length, send_task_id); 
+    task_message = receive_message(TIME_HANDLER_WAIT_FOREVER); 
+    block = 0; 
+    if (task_message == 0)
+    {
+        *length = 0; 
+        *send_task_id = TASK_ID_INVALID; 
+    }
+    else if (task_message->block == 0)
+    {
+        message_read(task_message, message, length, send_task_id); 
+        free_message(task_message); 
+    }
+    else
+    {
+        block = task_message->block; 
+        *length = task_message->length; 
+        *send_task_id = task_message->send_task_id; 
+        /* the block is kept, and only the message is freed */ 
+        task_message->block = 0; 
+        task_message->length = 0; 
+        free_message(task_message); 
+    }
     ENABLE_INTERRUPTS; 
+
+    /* copy a message sent by si_message_send to a new block */ 
+    if (task_message != 0 && block == 0)
+    {
+        block = si_message_alloc(); 
+        for (i = 0; i < *length; i++)
+        {
+            ((char *) block)[i] = message[i]; 
+        }
+    }
+    return block; 
 }
 
+/* message_call_type: a call, see si_message_send_receive, 
+   stored on the stack of a task while it waits */ 
+typedef struct
+{
+    /* the data to copy, and its length */ 
+    const void *data; 
+    int length; 
+    /* the buffer where data is copied, its size, and 
+       the number of bytes copied, or -1 */ 
+    void *buffer; 
+    int size; 
+    int n_copied; 
+    /* task_id for the calling task */ 
+    int task_id; 
+} message_call_type; 
+
+/* copy_call: copies data, with length bytes, to the buffer 
+   of call, where at most its size bytes are stored */ 
+static void copy_call(message_call_type *call, const void *data, int length)
+{
+    int i; 
+
+    if (length > call->size)
+    {
+        length = call->size; 
+    }
+    if (length < 0)
+    {
+        length = 0; 
+    }
+    for (i = 0; i < length; i++)
+    {
+        ((char *) call->buffer)[i] = ((const char *) data)[i]; 
+    }
+    call->n_copied = length; 
+}
+
+int si_message_send_receive(
+    int receive_task_id, const void *request, int request_length, 
+    void *reply, int reply_size)
+{
+    /* the call, where the reply is copied */ 
+    message_call_type call; 
+    /* the call of the receiving task, when it waits */ 
+    message_call_type *receive_call; 
+    tcb_message_type *tcb_message; 
+    task_control_block *tcb_receive; 
+    int task_id; 
+
+    if (receive_task_id < 0 || receive_task_id >= TCB_LIST_SIZE)
+    {
+        return -1; 
+    }
+    call.data = request; 
+    call.length = request_length; 
+    call.buffer = reply; 
+    call.size = reply_size; 
+    call.n_copied = -1; 
+
+    DISABLE_INTERRUPTS; 
+
+    task_id = task_get_task_id_running(); 
+    call.task_id = task_id; 
+    tcb_receive = tcb_storage_get_tcb_ref(receive_task_id); 
+    tcb_message = 0; 
+    if (receive_task_id != task_id && 
+        tcb_is_valid(tcb_receive) && !tcb_receive->has_exited)
+    {
+        tcb_message = get_mailbox(receive_task_id); 
+    }
+    if (tcb_message != 0)
+    {
+        tcb_storage_get_tcb_ref(task_id)->message_call = &call; 
+        ready_list_remove(task_id); 
+        if (tcb_message->call_receive_waiting)
+        {
+            /* copy the request to the receiving task, and 
+               switch to it, if it has high enough priority */ 
+            receive_call = tcb_receive->message_call; 
+            copy_call(receive_call, request, request_length); 
+            receive_call->task_id = task_id; 
+            tcb_message->call_receive_waiting = 0; 
+            wait_list_insert(&tcb_message->wait_list_reply, task_id); 
+            ready_list_insert(receive_task_id); 
+            schedule_handoff(receive_task_id); 
+        }
+        else
+        {
+            /* wait until the call is received, and replied. The 
+               receiving task may wait for the call in si_wait_any. */ 
+            wait_list_insert(&tcb_message->wait_list_call, task_id); 
+            wait_any_list_notify(&tcb_message->wait_any_list); 
+            schedule(); 
+        }
+        tcb_storage_get_tcb_ref(task_id)->message_call = 0; 
+    }
+
+    ENABLE_INTERRUPTS; 
+
+    return call.n_copied; 
+}
+
+int si_message_receive_request(void *request, int size, int *length)
+{
+    /* the call, where the request is copied */ 
+    message_call_type call; 
+    /* the call of a calling task which waits */ 
+    message_call_type *send_call; 
+    tcb_message_type *tcb_message; 
+    int task_id; 
+
+    call.buffer = request; 
+    call.size = size; 
+    call.n_copied = 0; 
+    call.task_id = TASK_ID_INVALID; 
+
+    DISABLE_INTERRUPTS; 
+
+    task_id = task_get_task_id_running(); 
+    tcb_message = get_mailbox(task_id); 
+    if (tcb_message != 0)
+    {
+        if (!wait_list_is_empty(&tcb_message->wait_list_call))
+        {
+            /* copy the request from the calling task 
+               with highest priority */ 
+            call.task_id = 
+                wait_list_remove_highest_prio(&tcb_message->wait_list_call); 
+            send_call = tcb_storage_get_tcb_ref(call.task_id)->message_call; 
+            copy_call(&call, send_call->data, send_call->length); 
+            wait_list_insert(&tcb_message->wait_list_reply, call.task_id); 
+        }
+        else
+        {
+            /* wait until a calling task copies its request */ 
+            tcb_storage_get_tcb_ref(task_id)->message_call = &call; 
+            tcb_message->call_receive_waiting = 1; 
+            ready_list_remove(task_id); 
+            schedule(); 
+            tcb_storage_get_tcb_ref(task_id)->message_call = 0; 
+        }
+    }
+
+    ENABLE_INTERRUPTS; 
+
+    *length = call.n_copied; 
+    return call.task_id; 
+}
+
+int si_message_reply(int call_task_id, const void *reply, int length)
+{
+    tcb_message_type *tcb_message; 
+    task_control_block *tcb_call; 
+    int result; 
+
+    if (call_task_id < 0 || call_task_id >= TCB_LIST_SIZE)
+    {
+        return -1; 
+    }
+
+    DISABLE_INTERRUPTS; 
+
+    result = -1; 
+    tcb_message = Mailbox[task_get_task_id_running()]; 
+    tcb_call = tcb_storage_get_tcb_ref(call_task_id); 
+    if (tcb_message != 0 && tcb_call->wait_list == &tcb_message->wait_list_reply)
+    {
+        /* copy the reply to the calling task, and switch 
+           to it, if it has higher priority */ 
+        copy_call(tcb_call->message_call, reply, length); 
+        wait_list_remove(&tcb_message->wait_list_reply, call_task_id); 
+        ready_list_insert(call_task_id); 
+        schedule_handoff(call_task_id); 
+        result = 0; 
+    }
+
+    ENABLE_INTERRUPTS; 
+
+    return result; 
+}
+
+wait_any_list_type *si_message_get_wait_any_list(void)
+{
+    tcb_message_type *tcb_message; 
+
+    tcb_message = get_mailbox(task_get_task_id_running()); 
+    return tcb_message != 0 ? &tcb_message->wait_any_list : 0; 
+}
+
+int si_message_is_available(void)
+{
+    tcb_message_type *tcb_message = Mailbox[task_get_task_id_running()]; 
+
+    return tcb_message != 0 && 
+        (tcb_message->priority_bitmap != 0 || 
+         !wait_list_is_empty(&tcb_message->wait_list_call)); 
+}
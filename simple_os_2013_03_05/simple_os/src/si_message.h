@@ -22,19 +22,76 @@
 #define SI_MESSAGE_H
 
 #include "task_message.h"
+#include "wait_any.h"
 
 #define MESSAGE_LENGTH MAX_MESSAGE_LENGTH
 
+/* size, in bytes, and number of the blocks used for messages 
+   passed without copying, which may be set at compile time, 
+   e.g. by -DSI_MESSAGE_BLOCK_SIZE=4096 */ 
+#ifndef SI_MESSAGE_BLOCK_SIZE
+#define SI_MESSAGE_BLOCK_SIZE 1024
+#endif
+#ifndef SI_MESSAGE_N_BLOCKS
+#define SI_MESSAGE_N_BLOCKS 8
+#endif
+
+/* number of mailboxes, and number of buffered messages with 
+   at most SI_MESSAGE_SMALL_SIZE bytes, and with at most 
+   MESSAGE_LENGTH bytes, shared by all tasks, which may be set 
+   at compile time. A task gets a mailbox when it first sends 
+   or receives a message, or when its depth is set. */ 
+#ifndef SI_MESSAGE_N_MAILBOXES
+#define SI_MESSAGE_N_MAILBOXES 8
+#endif
+#ifndef SI_MESSAGE_SMALL_SIZE
+#define SI_MESSAGE_SMALL_SIZE 32
+#endif
+#ifndef SI_MESSAGE_N_SMALL
+#define SI_MESSAGE_N_SMALL 32
+#endif
+#ifndef SI_MESSAGE_N_LARGE
+#define SI_MESSAGE_N_LARGE 16
+#endif
+
+/* the number of buffered messages in a mailbox, 
+   unless set by si_message_set_depth */ 
+#ifndef SI_MESSAGE_DEFAULT_DEPTH
+#define SI_MESSAGE_DEFAULT_DEPTH 2
+#endif
+
+/* number of message priorities, where 0 is the most urgent, 
+   and the priority of messages sent without a priority. A 
+   received message is the oldest message with the most urgent 
+   priority, and the depth of a mailbox applies to each priority, 
+   so that urgent messages are not delayed by a full mailbox. */ 
+#define SI_MESSAGE_N_PRIORITIES MESSAGE_N_PRIORITIES
+#define SI_MESSAGE_DEFAULT_PRIORITY (SI_MESSAGE_N_PRIORITIES - 1)
+
 void si_message_init(void); 
 
+/* si_message_set_depth: sets the number of messages which can 
+   be buffered for task_id, before a sending task waits. Shall 
+   be called when the task is created. Returns 0, or -1 if 
+   depth is less than 1, or no mailbox is available. */ 
+int si_message_set_depth(int task_id, int depth); 
+
 /* si_message_send: sends message, with length 
    characters, to task with task_id receive_task_id, 
-   using an internal buffer. 
+   using an internal buffer, where at most MESSAGE_LENGTH 
+   characters are stored. 
    The calling task will wait if the buffer 
-   is full. */
+   is full, or if all buffered messages are used. */
 void si_message_send(
     const char message[], int length, int receive_task_id); 
 
+/* si_message_send_prio: sends message as si_message_send, 
+   with priority in the range 0 .. SI_MESSAGE_N_PRIORITIES-1. 
+   The calling task will wait if there are depth buffered 
+   messages with the same priority. */ 
+void si_message_send_prio(
+    const char message[], int length, int receive_task_id, int priority); 
+
 /* si_message_receive: receives message, with *length
    characters, from task with task_id *send_task_id, 
    using an internal buffer. 
@@ -43,5 +100,104 @@ void si_message_send(
 void si_message_receive(
     char message[], int *length, int *send_task_id); 
 
+/* si_message_send_timed and si_message_receive_timed: send 
+   and receive as si_message_send and si_message_receive, where 
+   the calling task waits at most timeout_ms milliseconds. 
+   Return SI_OK, or SI_TIMEOUT if the timeout expired, see 
+   si_time.h. A sending task waits for a free buffered message, 
+   if all are used, and then for space in the mailbox, within 
+   the same timeout. A message is not sent if the receiving 
+   task is deleted. */ 
+int si_message_send_timed(
+    const char message[], int length, int receive_task_id, int timeout_ms); 
+int si_message_receive_timed(
+    char message[], int *length, int *send_task_id, int timeout_ms); 
+
+/* si_message_try_send and si_message_try_receive: send and 
+   receive without waiting. Return SI_OK, or SI_WOULD_BLOCK 
+   if the calling task would have waited, see si_time.h. */ 
+int si_message_try_send(
+    const char message[], int length, int receive_task_id); 
+int si_message_try_receive(
+    char message[], int *length, int *send_task_id); 
+
+/* si_message_alloc: returns a block of SI_MESSAGE_BLOCK_SIZE 
+   bytes, for a message sent by si_message_send_block. The 
+   calling task waits if all blocks are used. */ 
+void *si_message_alloc(void); 
+
+/* si_message_free: frees block, returned by si_message_alloc 
+   or si_message_receive_block */ 
+void si_message_free(void *block); 
+
+/* si_message_send_block: sends block, returned by 
+   si_message_alloc, with length bytes, to task with task_id 
+   receive_task_id. Only a reference to the block is buffered, 
+   so that the time used does not depend on length. The block 
+   is owned by the receiving task, and shall not be used by 
+   the calling task after the call. The calling task will 
+   wait if the buffer is full. */ 
+void si_message_send_block(void *block, int length, int receive_task_id); 
+
+/* si_message_send_block_prio: sends block as si_message_send_block, 
+   with priority as for si_message_send_prio */ 
+void si_message_send_block_prio(
+    void *block, int length, int receive_task_id, int priority); 
+
+/* si_message_receive_block: receives a message, with *length 
+   bytes, from task with task_id *send_task_id, and returns the 
+   block containing it, which shall be freed using si_message_free. 
+   A message sent by si_message_send is copied to a new block. 
+   The calling task will wait if the buffer is empty. 
+   Messages sent by si_message_send_block may also be received 
+   by si_message_receive, which copies at most MESSAGE_LENGTH 
+   bytes, and frees the block. */ 
+void *si_message_receive_block(int *length, int *send_task_id); 
+
+/* si_message_send_receive: sends a request, with request_length 
+   bytes, to task with task_id receive_task_id, and waits until 
+   the request is received by si_message_receive_request, and 
+   replied by si_message_reply. The request and the reply are 
+   copied once, directly between the buffers of the two tasks, 
+   and at most reply_size bytes are stored in reply. When the 
+   receiving task waits for a request, and has the same or higher 
+   priority, the calling task switches directly to it, and back 
+   when the reply has higher priority. Returns the number of bytes 
+   stored in reply, or -1 if the receiving task is not valid, or 
+   is deleted before it replies. */ 
+int si_message_send_receive(
+    int receive_task_id, const void *request, int request_length, 
+    void *reply, int reply_size); 
+
+/* si_message_receive_request: receives a request, sent by 
+   si_message_send_receive, where at most size bytes are stored 
+   in request, and *length is set to the number of stored bytes. 
+   Requests are received in priority order of the calling tasks. 
+   The calling task will wait if there is no request. Returns the 
+   task_id of the task which sent the request, and waits for a 
+   reply. */ 
+int si_message_receive_request(void *request, int size, int *length); 
+
+/* si_message_reply: sends a reply, with length bytes, to task with 
+   task_id call_task_id, which is made ready. Returns 0, or -1 if 
+   call_task_id does not wait for a reply from the calling task. */ 
+int si_message_reply(int call_task_id, const void *reply, int length); 
+
+/* si_message_get_wait_any_list: returns the list where the 
+   calling task waits in si_wait_any for a message, or a request, 
+   or 0 if no mailbox is available. Called with interrupts 
+   disabled. */ 
+wait_any_list_type *si_message_get_wait_any_list(void); 
+
+/* si_message_is_available: returns nonzero if the calling task 
+   has a buffered message, or a request, which can be received 
+   without waiting. Called with interrupts disabled. */ 
+int si_message_is_available(void); 
+
+/* si_message_reset_task: called when task_id is deleted. The 
+   messages sent to task_id are discarded, and tasks waiting to 
+   send to task_id, or for its reply, are made ready. */ 
+void si_message_reset_task(int task_id); 
+
 #endif
 
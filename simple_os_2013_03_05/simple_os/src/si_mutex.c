@@ -0,0 +1,246 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "si_mutex.h"
+
+#include "wait_list.h"
+#include "interrupt.h"
+#include "task.h"
+#include "tcb.h"
+#include "tcb_storage.h"
+#include "task_id_list.h"
+#include "ready_list.h"
+#include "schedule.h"
+#include "si_semaphore.h"
+
+/* set_owner: makes task_id the owner of mutex */ 
+static void set_owner(si_mutex *mutex, int task_id)
+{
+    /* the TCB for the new owner */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+
+    mutex->owner_task_id = task_id; 
+    mutex->next_held = tcb->held_mutexes; 
+    tcb->held_mutexes = mutex; 
+}
+
+/* remove_held: removes mutex from the mutexes held by task_id */ 
+static void remove_held(si_mutex *mutex, int task_id)
+{
+    /* the TCB for the owner */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    /* reference to the link to the mutex */ 
+    si_mutex **link = &tcb->held_mutexes; 
+
+    /* mutexes are most often released in the 
+       reverse order of locking, i.e. first in the list */ 
+    while (*link != mutex)
+    {
+        link = &(*link)->next_held; 
+    }
+    *link = mutex->next_held; 
+    mutex->next_held = 0; 
+}
+
+/* set_priority: sets the priority of task_id to priority, 
+   and moves the task in the ready list, or in the wait list 
+   where it waits, e.g. for a semaphore or a message */ 
+static void set_priority(int task_id, int priority)
+{
+    /* the wait list where the task is stored, if any */ 
+    wait_list_type *wait_list = tcb_storage_get_tcb_ref(task_id)->wait_list; 
+
+    if (wait_list != 0)
+    {
+        /* keep the wait list sorted by priority */ 
+        wait_list_change_priority(wait_list, task_id, priority); 
+    }
+    else
+    {
+        ready_list_change_priority(task_id, priority); 
+    }
+}
+
+/* inherit_priority: lets the owner of mutex inherit priority, 
+   and continues with the mutex which the owner waits for, 
+   until an owner already has the same or higher priority */ 
+static void inherit_priority(si_mutex *mutex, int priority)
+{
+    /* the owner of the mutex */ 
+    task_control_block *owner_tcb; 
+
+    while (mutex != 0)
+    {
+        owner_tcb = tcb_storage_get_tcb_ref(mutex->owner_task_id); 
+        if (owner_tcb->priority <= priority)
+        {
+            return; 
+        }
+        set_priority(owner_tcb->task_id, priority); 
+        /* continue with the mutex which the owner waits for */ 
+        mutex = owner_tcb->waiting_mutex; 
+    }
+}
+
+/* restored_priority: returns the base priority of the task with 
+   TCB tcb, or the highest of the ceilings of the semaphores it 
+   holds and the priorities of the tasks waiting for mutexes it 
+   holds, if higher */ 
+static int restored_priority(task_control_block *tcb)
+{
+    /* the priority to restore */ 
+    int priority = tcb->base_priority; 
+    /* a mutex held by the task */ 
+    si_mutex *mutex; 
+    /* a semaphore with ceiling held by the task */ 
+    si_semaphore *sem; 
+    /* the task with highest priority waiting for the mutex */ 
+    int waiting_task_id; 
+
+    for (sem = tcb->held_ceiling_sems; sem != 0; sem = sem->next_held)
+    {
+        if (sem->ceiling < priority)
+        {
+            priority = sem->ceiling; 
+        }
+    }
+    for (mutex = tcb->held_mutexes; mutex != 0; mutex = mutex->next_held)
+    {
+        waiting_task_id = mutex->wait_list.first_task_id; 
+        if (waiting_task_id != TASK_ID_INVALID && 
+            tcb_storage_get_tcb_ref(waiting_task_id)->priority < priority)
+        {
+            priority = tcb_storage_get_tcb_ref(waiting_task_id)->priority; 
+        }
+    }
+    return priority; 
+}
+
+void si_mutex_restore_priority(int task_id)
+{
+    /* the TCB for the task */ 
+    task_control_block *tcb; 
+    /* the priority to restore */ 
+    int priority; 
+
+    while (task_id != TASK_ID_INVALID)
+    {
+        tcb = tcb_storage_get_tcb_ref(task_id); 
+        priority = restored_priority(tcb); 
+        if (priority == tcb->priority)
+        {
+            return; 
+        }
+        set_priority(task_id, priority); 
+        /* the owner of the mutex which the task waits for, if 
+           any, may have inherited the old priority of the task, 
+           so continue with the owner, as in inherit_priority */ 
+        if (tcb->waiting_mutex == 0)
+        {
+            return; 
+        }
+        task_id = tcb->waiting_mutex->owner_task_id; 
+    }
+}
+
+void si_mutex_init(si_mutex *mutex)
+{
+    wait_list_reset(&mutex->wait_list); 
+    mutex->owner_task_id = TASK_ID_INVALID; 
+    mutex->next_held = 0; 
+}
+
+void si_mutex_lock(si_mutex *mutex)
+{
+    /* task id and TCB for the running task */ 
+    int task_id; 
+    task_control_block *tcb; 
+
+    /* disable interrupts */ 
+    DISABLE_INTERRUPTS; 
+
+    task_id = task_get_task_id_running(); 
+    if (mutex->owner_task_id == TASK_ID_INVALID)
+    {
+        /* the mutex is free */ 
+        set_owner(mutex, task_id); 
+    }
+    else
+    {
+        tcb = tcb_storage_get_tcb_ref(task_id); 
+        /* wait for the mutex */ 
+        ready_list_remove(task_id); 
+        tcb->waiting_mutex = mutex; 
+        wait_list_insert(&mutex->wait_list, task_id); 
+        /* let the owner run with the priority of this task */ 
+        inherit_priority(mutex, tcb->priority); 
+        /* call schedule. When the task runs again, 
+           it has been made the owner by si_mutex_unlock */ 
+        schedule(); 
+    }
+
+    /* enable interrupts */ 
+    ENABLE_INTERRUPTS; 
+}
+
+void si_mutex_unlock(si_mutex *mutex)
+{
+    /* task id for the running task */ 
+    int task_id; 
+    /* task id for the next owner */ 
+    int next_task_id; 
+
+    /* disable interrupts */ 
+    DISABLE_INTERRUPTS; 
+
+    task_id = task_get_task_id_running(); 
+    if (mutex->owner_task_id != task_id)
+    {
+        /* only the owner can unlock the mutex */ 
+        ENABLE_INTERRUPTS; 
+        return; 
+    }
+    remove_held(mutex, task_id); 
+
+    if (!wait_list_is_empty(&mutex->wait_list))
+    {
+        /* hand over the mutex to the waiting task 
+           with highest priority */ 
+        next_task_id = wait_list_remove_highest_prio(&mutex->wait_list); 
+        tcb_storage_get_tcb_ref(next_task_id)->waiting_mutex = 0; 
+        set_owner(mutex, next_task_id); 
+        /* the new owner inherits from the remaining waiters */ 
+        si_mutex_restore_priority(next_task_id); 
+        ready_list_insert(next_task_id); 
+    }
+    else
+    {
+        mutex->owner_task_id = TASK_ID_INVALID; 
+    }
+
+    /* stop inheriting priority via this mutex */ 
+    si_mutex_restore_priority(task_id); 
+
+    /* call schedule */ 
+    schedule(); 
+
+    /* enable interrupts */ 
+    ENABLE_INTERRUPTS; 
+}
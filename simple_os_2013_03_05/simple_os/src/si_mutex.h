@@ -0,0 +1,66 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef SI_MUTEX_H
+#define SI_MUTEX_H
+
+#include "wait_list.h"
+
+/* a mutex, with priority inheritance. A task holding the 
+   mutex runs with the highest priority of the tasks waiting 
+   for it, also when the waiting is transitive, i.e. when the 
+   holder in turn waits for another mutex. */ 
+typedef struct si_mutex_struct
+{
+    /* the list of waiting tasks */ 
+    wait_list_type wait_list; 
+    /* task id of the task holding the mutex, 
+       or TASK_ID_INVALID if the mutex is free */ 
+    int owner_task_id; 
+    /* the next mutex held by the same task */ 
+    struct si_mutex_struct *next_held; 
+} si_mutex; 
+
+/* si_mutex_init: initialises mutex, which becomes free */ 
+void si_mutex_init(si_mutex *mutex); 
+
+/* si_mutex_lock: locks mutex, and waits if it is held by 
+   another task. The holder inherits the priority of the 
+   calling task, if it is higher. */ 
+void si_mutex_lock(si_mutex *mutex); 
+
+/* si_mutex_unlock: unlocks mutex, which shall be held by 
+   the calling task. The mutex is handed over to the waiting 
+   task with highest priority, and the priority of the 
+   calling task is restored. */ 
+void si_mutex_unlock(si_mutex *mutex); 
+
+/* si_mutex_restore_priority: sets the priority of task_id to 
+   its base priority, or to the highest of the ceilings of the 
+   semaphores held by task_id, see si_sem_init_ceiling, and the 
+   priorities of the tasks waiting for mutexes held by task_id, 
+   if higher. If task_id waits for a mutex, the priority of 
+   its owner, and further owners along the chain of waiting 
+   tasks, is recomputed in the same way. Called with interrupts 
+   disabled, also when a semaphore with ceiling is taken or 
+   released. */ 
+void si_mutex_restore_priority(int task_id); 
+
+#endif
@@ -0,0 +1,191 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "si_periodic.h"
+
+#include "task.h"
+#include "tcb.h"
+#include "tcb_storage.h"
+#include "time_handler.h"
+#include "time_storage.h"
+#include "tick_handler.h"
+#include "ready_list.h"
+#include "schedule.h"
+
+#include "interrupt.h"
+
+/* register_release: updates the release statistics 
+   in *tcb, for a task which has been released */ 
+static void register_release(task_control_block *tcb)
+{
+    /* the time from the planned release until now */ 
+    long jitter_us = (long) (time_storage_get_time_us() - tcb->release_us); 
+
+    if (tcb->n_releases == 0 || jitter_us < tcb->min_jitter_us)
+    {
+        tcb->min_jitter_us = jitter_us; 
+    }
+    if (tcb->n_releases == 0 || jitter_us > tcb->max_jitter_us)
+    {
+        tcb->max_jitter_us = jitter_us; 
+    }
+    tcb->sum_jitter_us += jitter_us; 
+    tcb->n_releases++; 
+}
+
+/* begin_deadline_change: prepares for a change of the 
+   deadline of task_id, which is in the ready list */ 
+static void begin_deadline_change(int task_id)
+{
+#ifdef EDF_SCHEDULING
+    /* the order in the ready list depends on the deadline */ 
+    ready_list_remove(task_id); 
+#endif
+}
+
+/* end_deadline_change: ends a change of the deadline of 
+   task_id, started by begin_deadline_change */ 
+static void end_deadline_change(int task_id)
+{
+#ifdef EDF_SCHEDULING
+    ready_list_insert(task_id); 
+    schedule(); 
+#endif
+}
+
+/* calculate_n_ticks: returns the number of ticks to wait, 
+   from the latest registered tick, until the time time_us */ 
+static int calculate_n_ticks(long long time_us)
+{
+    /* number of microseconds per tick */ 
+    long n_us_per_tick = time_storage_get_us_per_tick(); 
+    /* number of ticks, rounded up */ 
+    long long n_ticks = 
+        (time_us - time_storage_get_tick_time_us() + n_us_per_tick - 1) / 
+        n_us_per_tick; 
+
+    return n_ticks < 1 ? 1 : (int) n_ticks; 
+}
+
+void si_task_periodic(int period_ms, int deadline_ms)
+{
+    /* the TCB for the calling task */ 
+    task_control_block *tcb; 
+
+    /* disable interrupts */ 
+    DISABLE_INTERRUPTS; 
+
+    tcb = tcb_storage_get_tcb_ref(task_get_task_id_running()); 
+    begin_deadline_change(tcb->task_id); 
+    tcb->is_periodic = 1; 
+    tcb->period_us = period_ms * 1000L; 
+    tcb->deadline_us = 
+        (deadline_ms > 0 ? deadline_ms : period_ms) * 1000L; 
+    tcb->release_us = time_storage_get_time_us(); 
+    tcb->n_releases = 0; 
+    tcb->n_overruns = 0; 
+    tcb->n_deadline_misses = 0; 
+    tcb->min_jitter_us = 0; 
+    tcb->max_jitter_us = 0; 
+    tcb->sum_jitter_us = 0; 
+    register_release(tcb); 
+    end_deadline_change(tcb->task_id); 
+
+    /* enable interrupts */ 
+    ENABLE_INTERRUPTS; 
+}
+
+void si_wait_next_period(void)
+{
+    /* the TCB for the calling task */ 
+    task_control_block *tcb; 
+    /* the current time */ 
+    long long now_us; 
+
+    /* disable interrupts */ 
+    DISABLE_INTERRUPTS; 
+
+    tcb = tcb_storage_get_tcb_ref(task_get_task_id_running()); 
+
+    /* bring the time up to date */ 
+    tick_handler_update_time(); 
+    now_us = time_storage_get_time_us(); 
+
+    /* check the deadline for the current period */ 
+    if (now_us > tcb->release_us + tcb->deadline_us)
+    {
+        tcb->n_deadline_misses++; 
+    }
+
+    /* the next release is one period after the 
+       current release */ 
+    if (tcb->release_us + tcb->period_us <= now_us)
+    {
+        /* the task is released at once */ 
+        begin_deadline_change(tcb->task_id); 
+        tcb->release_us += tcb->period_us; 
+        tcb->n_overruns++; 
+        end_deadline_change(tcb->task_id); 
+    }
+    else
+    {
+        /* the task leaves the ready list when it starts 
+           waiting, so the deadline can be changed here */ 
+        tcb->release_us += tcb->period_us; 
+        time_handler_wait_n_ticks(calculate_n_ticks(tcb->release_us)); 
+    }
+    register_release(tcb); 
+
+    /* enable interrupts */ 
+    ENABLE_INTERRUPTS; 
+}
+
+int si_task_get_periodic_stats(int task_id, si_periodic_stats *stats)
+{
+    /* the TCB for the task */ 
+    task_control_block *tcb; 
+
+    if (task_id < 0 || task_id >= tcb_storage_get_tcb_list_size())
+    {
+        return -1; 
+    }
+
+    /* disable interrupts */ 
+    DISABLE_INTERRUPTS; 
+
+    tcb = tcb_storage_get_tcb_ref(task_id); 
+    if (!tcb_is_valid(tcb))
+    {
+        ENABLE_INTERRUPTS; 
+        return -1; 
+    }
+    stats->n_releases = tcb->n_releases; 
+    stats->n_overruns = tcb->n_overruns; 
+    stats->n_deadline_misses = tcb->n_deadline_misses; 
+    stats->min_jitter_us = tcb->min_jitter_us; 
+    stats->max_jitter_us = tcb->max_jitter_us; 
+    stats->mean_jitter_us = tcb->n_releases > 0 ? 
+        (long) (tcb->sum_jitter_us / tcb->n_releases) : 0; 
+
+    /* enable interrupts */ 
+    ENABLE_INTERRUPTS; 
+
+    return 0; 
+}
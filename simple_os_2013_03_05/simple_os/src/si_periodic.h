@@ -0,0 +1,62 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef SI_PERIODIC_H
+#define SI_PERIODIC_H
+
+/* release statistics for a periodic task. The jitter 
+   is the time from the planned release of the task 
+   until the task runs. */ 
+typedef struct
+{
+    /* number of releases */ 
+    int n_releases; 
+    /* number of periods where the task was still running 
+       at the time of the next release */ 
+    int n_overruns; 
+    /* number of periods where the task finished 
+       after its deadline */ 
+    int n_deadline_misses; 
+    /* release jitter, in microseconds */ 
+    long min_jitter_us; 
+    long max_jitter_us; 
+    long mean_jitter_us; 
+} si_periodic_stats; 
+
+/* si_task_periodic: makes the calling task periodic, with 
+   period period_ms milliseconds, and deadline deadline_ms 
+   milliseconds after each release. A deadline_ms of 0 sets 
+   the deadline equal to the period. The first release is 
+   at the time of the call. */ 
+void si_task_periodic(int period_ms, int deadline_ms); 
+
+/* si_wait_next_period: ends the current period of the 
+   calling periodic task, and makes it wait until its next 
+   release. The release times are kept as absolute times, 
+   so that they do not drift. A task which has overrun its 
+   period is released at once. */ 
+void si_wait_next_period(void); 
+
+/* si_task_get_periodic_stats: returns, in *stats, the 
+   release statistics for the periodic task task_id. Returns 
+   0, or -1 if task_id is not the id of a created task. */ 
+int si_task_get_periodic_stats(int task_id, si_periodic_stats *stats); 
+
+#endif
@@ -0,0 +1,174 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+#include "si_pool.h"
+
+#include "wait_list.h"
+#include "interrupt.h"
+#include "task.h"
+#include "tcb.h"
+#include "tcb_storage.h"
+#include "ready_list.h"
+#include "schedule.h"
+#include "time_handler.h"
+
+/* the next free block, stored first in a free block */ 
+#define NEXT_FREE(block) ((block)->p)
+
+void si_pool_init(
+    si_pool *pool, si_pool_item memory[], int block_size, int n_blocks)
+{
+    int i; 
+
+    wait_list_reset(&pool->wait_list); 
+    pool->memory = memory; 
+    pool->block_n_items = 
+        (block_size + sizeof(si_pool_item) - 1) / sizeof(si_pool_item); 
+    if (pool->block_n_items < 1)
+    {
+        pool->block_n_items = 1; 
+    }
+    pool->n_blocks = n_blocks; 
+
+    /* link all blocks in the free list, in address order */ 
+    pool->free_list = 0; 
+    for (i = n_blocks - 1; i >= 0; i--)
+    {
+        NEXT_FREE(&memory[i * pool->block_n_items]) = pool->free_list; 
+        pool->free_list = &memory[i * pool->block_n_items]; 
+    }
+    pool->n_free = n_blocks; 
+    pool->min_free = n_blocks; 
+    pool->n_allocs = 0; 
+    pool->n_waits = 0; 
+}
+
+void *si_pool_take_block(si_pool *pool)
+{
+    /* the first free block */ 
+    si_pool_item *block = pool->free_list; 
+
+    if (block == 0)
+    {
+        return 0; 
+    }
+    pool->free_list = NEXT_FREE(block); 
+    pool->n_free--; 
+    if (pool->n_free < pool->min_free)
+    {
+        pool->min_free = pool->n_free; 
+    }
+    pool->n_allocs++; 
+    return block; 
+}
+
+void *si_pool_alloc(si_pool *pool)
+{
+    /* the allocated block */ 
+    void *block; 
+
+    DISABLE_INTERRUPTS; 
+    block = si_pool_wait_block(pool, TIME_HANDLER_WAIT_FOREVER); 
+    ENABLE_INTERRUPTS; 
+
+    return block; 
+}
+
+void *si_pool_wait_block(si_pool *pool, int n_ticks)
+{
+    /* the allocated block */ 
+    void *block; 
+    /* task id */ 
+    int task_id; 
+
+    block = si_pool_take_block(pool); 
+    if (block == 0 && n_ticks != 0)
+    {
+        /* wait until a block is given by si_pool_free, 
+           or the timeout expires */ 
+        task_id = task_get_task_id_running(); 
+        ready_list_remove(task_id); 
+        wait_list_insert(&pool->wait_list, task_id); 
+        if (n_ticks != TIME_HANDLER_WAIT_FOREVER)
+        {
+            time_handler_start_timeout(n_ticks); 
+        }
+        pool->n_waits++; 
+        schedule(); 
+        /* the block is 0 if the timeout expired */ 
+        block = tcb_storage_get_tcb_ref(task_id)->pool_block; 
+        tcb_storage_get_tcb_ref(task_id)->pool_block = 0; 
+    }
+    return block; 
+}
+
+void *si_pool_try_alloc(si_pool *pool)
+{
+    /* the allocated block */ 
+    void *block; 
+
+    DISABLE_INTERRUPTS; 
+    block = si_pool_take_block(pool); 
+    ENABLE_INTERRUPTS; 
+
+    return block; 
+}
+
+void si_pool_put_block(si_pool *pool, void *block)
+{
+    /* task id */ 
+    int task_id; 
+
+    if (!wait_list_is_empty(&pool->wait_list))
+    {
+        /* give the block to the waiting task with highest priority */ 
+        task_id = wait_list_remove_highest_prio(&pool->wait_list); 
+        tcb_storage_get_tcb_ref(task_id)->pool_block = block; 
+        pool->n_allocs++; 
+        ready_list_insert(task_id); 
+        schedule(); 
+    }
+    else
+    {
+        NEXT_FREE((si_pool_item *) block) = pool->free_list; 
+        pool->free_list = (si_pool_item *) block; 
+        pool->n_free++; 
+    }
+}
+
+void si_pool_free(si_pool *pool, void *block)
+{
+    DISABLE_INTERRUPTS; 
+    si_pool_put_block(pool, block); 
+    ENABLE_INTERRUPTS; 
+}
+
+void si_pool_get_stats(si_pool *pool, si_pool_stats *stats)
+{
+    DISABLE_INTERRUPTS; 
+
+    stats->block_size = pool->block_n_items * sizeof(si_pool_item); 
+    stats->n_blocks = pool->n_blocks; 
+    stats->n_free = pool->n_free; 
+    stats->max_used = pool->n_blocks - pool->min_free; 
+    stats->n_allocs = pool->n_allocs; 
+    stats->n_waits = pool->n_waits; 
+
+    ENABLE_INTERRUPTS; 
+}
@@ -0,0 +1,116 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+#ifndef SI_POOL_H
+#define SI_POOL_H
+
+#include "wait_list.h"
+
+/* the memory for a pool is an array of si_pool_item, 
+   which is aligned for all kinds of blocks */ 
+typedef union
+{
+    long long ll; 
+    double d; 
+    void *p; 
+} si_pool_item; 
+
+/* SI_POOL_N_ITEMS: the number of si_pool_item needed for 
+   a pool with n_blocks blocks of block_size bytes, e.g. 
+   static si_pool_item Memory[SI_POOL_N_ITEMS(64, 10)]; */ 
+#define SI_POOL_N_ITEMS(block_size, n_blocks) \
+    ((((block_size) + sizeof(si_pool_item) - 1) / \
+      sizeof(si_pool_item)) * (n_blocks))
+
+/* a pool of fixed-size blocks. The free blocks are 
+   linked in a list, stored in the blocks themselves, so 
+   that blocks are allocated and freed in constant time. */ 
+typedef struct
+{
+    /* the list of tasks waiting for a block */ 
+    wait_list_type wait_list; 
+    /* the memory for the blocks */ 
+    si_pool_item *memory; 
+    /* block size, in si_pool_item, and number of blocks */ 
+    int block_n_items; 
+    int n_blocks; 
+    /* the first free block, or 0 if all blocks are used */ 
+    si_pool_item *free_list; 
+    /* number of free blocks, and the lowest 
+       number of free blocks so far */ 
+    int n_free; 
+    int min_free; 
+    /* number of allocations, and number of allocations 
+       where the calling task waited */ 
+    long n_allocs; 
+    long n_waits; 
+} si_pool; 
+
+/* usage statistics for a pool, as returned by si_pool_get_stats */ 
+typedef struct
+{
+    /* block size, in bytes, rounded up to whole si_pool_item */ 
+    int block_size; 
+    /* number of blocks, and number of free blocks */ 
+    int n_blocks; 
+    int n_free; 
+    /* the largest number of blocks used at the same time */ 
+    int max_used; 
+    /* number of allocations, and number of allocations 
+       where the calling task waited for a free block */ 
+    long n_allocs; 
+    long n_waits; 
+} si_pool_stats; 
+
+/* si_pool_init: initialises pool, with n_blocks blocks of 
+   block_size bytes, stored in memory, which shall have 
+   SI_POOL_N_ITEMS(block_size, n_blocks) items */ 
+void si_pool_init(
+    si_pool *pool, si_pool_item memory[], int block_size, int n_blocks); 
+
+/* si_pool_alloc: returns a block from pool, and waits 
+   for a block to be freed if there is no free block */ 
+void *si_pool_alloc(si_pool *pool); 
+
+/* si_pool_try_alloc: returns a block from pool, or 0 
+   if there is no free block */ 
+void *si_pool_try_alloc(si_pool *pool); 
+
+/* si_pool_free: returns block, allocated from pool, to pool. 
+   The block is given to the waiting task with highest 
+   priority, if any. */ 
+void si_pool_free(si_pool *pool, void *block); 
+
+/* si_pool_take_block and si_pool_put_block: allocate and free 
+   as si_pool_try_alloc and si_pool_free, for use in the kernel, 
+   when interrupts are disabled */ 
+void *si_pool_take_block(si_pool *pool); 
+void si_pool_put_block(si_pool *pool, void *block); 
+
+/* si_pool_wait_block: allocates as si_pool_take_block, and 
+   waits at most n_ticks ticks for a block to be freed if there 
+   is no free block, where TIME_HANDLER_WAIT_FOREVER means that 
+   there is no timeout. Returns 0 if no block was allocated. 
+   For use in the kernel, when interrupts are disabled. */ 
+void *si_pool_wait_block(si_pool *pool, int n_ticks); 
+
+/* si_pool_get_stats: returns, in *stats, the usage of pool */ 
+void si_pool_get_stats(si_pool *pool, si_pool_stats *stats); 
+
+#endif
@@ -21,20 +21,97 @@
 #include "si_semaphore.h"
 
 #include "wait_list.h"
+#include "wait_any.h"
 #include "interrupt.h"
 #include "task.h"
+#include "tcb.h"
+#include "tcb_storage.h"
+#include "task_id_list.h"
 #include "ready_list.h"
 #include "schedule.h"
+#include "si_mutex.h"
+#include "si_time.h"
+#include "time_handler.h"
 
 /* fig_begin si_sem_init */ 
 /* si_sem_init: intialisation of semaphore sem */ 
 void si_sem_init(si_semaphore *sem, int init_val)
 {
-    wait_list_reset(sem->wait_list, WAIT_LIST_SIZE); 
+    wait_list_reset(&sem->wait_list); 
     sem->counter = init_val; 
+    sem->ceiling = SI_SEM_NO_CEILING; 
+    sem->holder_task_id = TASK_ID_INVALID; 
+    sem->next_held = 0; 
+    wait_any_list_reset(&sem->wait_any_list); 
 }
 /* fig_end si_sem_init */ 
 
+void si_sem_init_ceiling(si_semaphore *sem, int init_val, int ceiling)
+{
+    si_sem_init(sem, init_val); 
+    sem->ceiling = ceiling; 
+}
+
+/* remove_holder: removes sem from the semaphores with ceiling 
+   held by its holder, and restores the priority of the holder */ 
+static void remove_holder(si_semaphore *sem)
+{
+    /* the holder */ 
+    int task_id = sem->holder_task_id; 
+    /* reference to the link to the semaphore */ 
+    si_semaphore **link = 
+        &tcb_storage_get_tcb_ref(task_id)->held_ceiling_sems; 
+
+    /* semaphores are most often released in the 
+       reverse order of taking, i.e. first in the list */ 
+    while (*link != sem)
+    {
+        link = &(*link)->next_held; 
+    }
+    *link = sem->next_held; 
+    sem->next_held = 0; 
+    sem->holder_task_id = TASK_ID_INVALID; 
+
+    /* use the ceilings of the remaining semaphores, 
+       and priority inherited via held mutexes */ 
+    si_mutex_restore_priority(task_id); 
+}
+
+void si_sem_set_holder(si_semaphore *sem, int task_id)
+{
+    /* the TCB for the holder */ 
+    task_control_block *tcb; 
+
+    if (sem->ceiling == SI_SEM_NO_CEILING)
+    {
+        return; 
+    }
+    if (sem->holder_task_id != TASK_ID_INVALID)
+    {
+        /* sem was signalled by another task than its holder */ 
+        remove_holder(sem); 
+    }
+    tcb = tcb_storage_get_tcb_ref(task_id); 
+    sem->holder_task_id = task_id; 
+    sem->next_held = tcb->held_ceiling_sems; 
+    tcb->held_ceiling_sems = sem; 
+    if (sem->ceiling < tcb->priority)
+    {
+        /* run at the ceiling for the whole critical section */ 
+        si_mutex_restore_priority(task_id); 
+    }
+}
+
+void si_sem_clear_holder(si_semaphore *sem)
+{
+    if (sem->ceiling == SI_SEM_NO_CEILING || 
+        sem->holder_task_id != task_get_task_id_running())
+    {
+        return; 
+    }
+    remove_holder(sem); 
+}
+
 /* fig_begin si_sem_wait */ 
 /* si_sem_wait: wait operation on semaphore sem */ 
 void si_sem_wait(si_semaphore *sem)
@@ -49,6 +126,8 @@ void si_sem_wait(si_semaphore *sem)
     {
         /* decrement */ 
         sem->counter--; 
+        /* raise priority to the ceiling, if any */ 
+        si_sem_set_holder(sem, task_get_task_id_running()); 
     }
     else
     {
@@ -57,8 +136,7 @@ void si_sem_wait(si_semaphore *sem)
         /* remove it from ready list */ 
         ready_list_remove(task_id); 
         /* insert it into the semaphore waiting list */ 
-        wait_list_insert(
-            sem->wait_list, WAIT_LIST_SIZE, task_id); 
+        wait_list_insert(&sem->wait_list, task_id); 
         /* call schedule */ 
         schedule(); 
     }
@@ -67,6 +145,74 @@ void si_sem_wait(si_semaphore *sem)
 }
 /* fig_end si_sem_wait */ 
 
+/* si_sem_wait_timed: wait operation on semaphore sem, 
+   with a timeout */ 
+int si_sem_wait_timed(si_semaphore *sem, int timeout_ms)
+{
+    /* task id */ 
+    int task_id; 
+    /* the result */ 
+    int result; 
+
+    if (timeout_ms <= 0)
+    {
+        return si_sem_try_wait(sem) == SI_OK ? SI_OK : SI_TIMEOUT; 
+    }
+
+    DISABLE_INTERRUPTS; 
+
+    result = SI_OK; 
+    if (sem->counter > 0)
+    {
+        sem->counter--; 
+        si_sem_set_holder(sem, task_get_task_id_running()); 
+    }
+    else
+    {
+        /* wait in the semaphore waiting list, and in the time list */ 
+        task_id = task_get_task_id_running();
+        ready_list_remove(task_id); 
+        wait_list_insert(&sem->wait_list, task_id); 
+        time_handler_start_timeout(si_time_ms_to_ticks(timeout_ms)); 
+        schedule(); 
+        if (time_handler_has_timed_out())
+        {
+            result = SI_TIMEOUT; 
+        }
+    }
+
+    ENABLE_INTERRUPTS; 
+
+    return result; 
+}
+
+int si_sem_take(si_semaphore *sem)
+{
+    if (sem->counter > 0)
+    {
+        sem->counter--; 
+        si_sem_set_holder(sem, task_get_task_id_running()); 
+        return 1; 
+    }
+    return 0; 
+}
+
+/* si_sem_try_wait: wait operation on semaphore sem, 
+   without waiting */ 
+int si_sem_try_wait(si_semaphore *sem)
+{
+    /* the result */ 
+    int result; 
+
+    DISABLE_INTERRUPTS; 
+
+    result = si_sem_take(sem) ? SI_OK : SI_WOULD_BLOCK; 
+
+    ENABLE_INTERRUPTS; 
+
+    return result; 
+}
+
 /* fig_begin si_sem_signal */ 
 /* si_sem_signal: signal operation on semaphore sem */ 
 void si_sem_signal(si_semaphore *sem)
@@ -77,13 +223,16 @@ void si_sem_signal(si_semaphore *sem)
     /* disable interrupts */ 
     DISABLE_INTERRUPTS; 
 
+    /* restore priority of the holder, if sem has a ceiling */ 
+    si_sem_clear_holder(sem); 
+
     /* check if tasks are waiting */ 
-    if (!wait_list_is_empty(
-            sem->wait_list, WAIT_LIST_SIZE))
+    if (!wait_list_is_empty(&sem->wait_list))
     {
         /* get task_id with highest priority */ 
-        task_id = wait_list_remove_highest_prio(
-            sem->wait_list, WAIT_LIST_SIZE); 
+        task_id = wait_list_remove_highest_prio(&sem->wait_list); 
+        /* the task becomes the holder */ 
+        si_sem_set_holder(sem, task_id); 
         /* make this task ready to run */ 
         ready_list_insert(task_id); 
         /* call schedule */ 
@@ -93,6 +242,13 @@ void si_sem_signal(si_semaphore *sem)
     {
         /* increment counter */ 
         sem->counter++; 
+        /* the priority may have been lowered, or a task 
+           waiting in si_wait_any may have been made ready */ 
+        if (wait_any_list_notify(&sem->wait_any_list) > 0 || 
+            sem->ceiling != SI_SEM_NO_CEILING)
+        {
+            schedule(); 
+        }
     }
     /* enable interrupts */ 
     ENABLE_INTERRUPTS; 
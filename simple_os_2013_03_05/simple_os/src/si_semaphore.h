@@ -21,24 +21,70 @@
 #ifndef SEMAPHORE_H
 #define SEMAPHORE_H
 
-#include "tcb_storage.h"
+#include "wait_list.h"
+#include "wait_any.h"
 
-#define WAIT_LIST_SIZE TCB_LIST_SIZE
+/* ceiling for a semaphore without priority ceiling */ 
+#define SI_SEM_NO_CEILING -1
 
 /* fig_begin sem_def */ 
-typedef struct 
+typedef struct si_semaphore_struct
 {
     /* the list of waiting processes */ 
-    int wait_list[WAIT_LIST_SIZE]; 
+    wait_list_type wait_list; 
     /* semaphore value */
     int counter; 
+    /* ceiling priority, or SI_SEM_NO_CEILING */ 
+    int ceiling; 
+    /* task id of the task holding a semaphore 
+       with ceiling, or TASK_ID_INVALID */ 
+    int holder_task_id; 
+    /* the next semaphore with ceiling held by the same task */ 
+    struct si_semaphore_struct *next_held; 
+    /* the list of tasks waiting in si_wait_any */ 
+    wait_any_list_type wait_any_list; 
 } si_semaphore; 
 /* fig_end sem_def */ 
 
 void si_sem_init(si_semaphore *sem, int init_val); 
 
+/* si_sem_init_ceiling: initialises sem, used for mutual 
+   exclusion, with the immediate priority ceiling protocol. 
+   The task holding sem runs with priority ceiling, which 
+   shall be the highest priority of the tasks using sem, 
+   during the whole critical section. init_val shall be 1. */ 
+void si_sem_init_ceiling(si_semaphore *sem, int init_val, int ceiling); 
+
 void si_sem_wait(si_semaphore *sem); 
 
+/* si_sem_wait_timed: wait operation on sem, where the calling 
+   task waits at most timeout_ms milliseconds. Returns SI_OK, or 
+   SI_TIMEOUT if the timeout expired, see si_time.h. */ 
+int si_sem_wait_timed(si_semaphore *sem, int timeout_ms); 
+
+/* si_sem_try_wait: wait operation on sem, which returns at 
+   once. Returns SI_OK, or SI_WOULD_BLOCK if the calling task 
+   would have waited, see si_time.h. */ 
+int si_sem_try_wait(si_semaphore *sem); 
+
 void si_sem_signal(si_semaphore *sem); 
 
+/* si_sem_take: decrements the value of sem, if it is positive, 
+   as si_sem_try_wait. Returns nonzero if the value was 
+   decremented. Called with interrupts disabled, by si_wait_any. */ 
+int si_sem_take(si_semaphore *sem); 
+
+/* si_sem_set_holder: makes task_id the holder of sem, and 
+   raises its priority to the ceiling of sem, if sem has a 
+   ceiling. A previous holder no longer holds sem. Called with 
+   interrupts disabled, also by si_condvar. */ 
+void si_sem_set_holder(si_semaphore *sem, int task_id); 
+
+/* si_sem_clear_holder: ends the holding of sem, if sem has a 
+   ceiling, and the calling task is the holder. Its priority 
+   is then restored, using the ceilings of the semaphores it 
+   still holds. Called with interrupts disabled, also by 
+   si_condvar. */ 
+void si_sem_clear_holder(si_semaphore *sem); 
+
 #endif
@@ -22,25 +22,28 @@
 
 #include "time_handler.h"
 #include "time_storage.h"
+#include "tick_handler.h"
+#include "schedule.h"
 
 #include "interrupt.h"
 
 #include "console.h"
 
-static int calculate_n_ticks(int n_ms)
+int si_time_ms_to_ticks(int n_ms)
 {
-    /* number of milliseconds per tick */ 
-    int n_ms_per_tick; 
+    /* number of microseconds per tick */ 
+    long n_us_per_tick; 
 
     /* number of ticks */ 
-    int n_ticks; 
+    long long n_ticks; 
 
-    n_ms_per_tick = time_storage_get_ms_per_tick(); 
+    n_us_per_tick = time_storage_get_us_per_tick(); 
 
-    n_ticks = 1; 
-    while (n_ticks * n_ms_per_tick < n_ms)
-    {	
-        n_ticks++; 
+    /* round up, and wait at least one tick */ 
+    n_ticks = (n_ms * 1000LL + n_us_per_tick - 1) / n_us_per_tick; 
+    if (n_ticks < 1)
+    {
+        n_ticks = 1; 
     }
 
     // console_put_hex(n_ms); 
@@ -48,7 +51,7 @@ static int calculate_n_ticks(int n_ms)
     // console_put_hex(n_ticks); 
     // console_put_string(" ticks\n"); 
 
-    return n_ticks; 
+    return (int) n_ticks; 
 }
 
 /* si_wait_n_ms: makes the calling process wait n_ms
@@ -59,7 +62,7 @@ void si_wait_n_ms(int n_ms)
     DISABLE_INTERRUPTS; 
 
     /* wait a calculated number of ticks */ 
-    time_handler_wait_n_ticks(calculate_n_ticks(n_ms)); 
+    time_handler_wait_n_ticks(si_time_ms_to_ticks(n_ms)); 
 
     /* enable interrupts */ 
     ENABLE_INTERRUPTS; 
@@ -80,12 +83,15 @@ void si_wait_until_time(si_time *time)
     /* disable interrupts */ 
     DISABLE_INTERRUPTS; 
 
+    /* bring the time up to date */ 
+    tick_handler_update_time(); 
+
     /* get the current time */ 
     time_storage_get_current_time(&current_time); 
     
     /* calculate number of ticks to wait */ 
     n_ms = si_time_diff_n_ms(time, &current_time); 
-    n_ticks = calculate_n_ticks(n_ms); 
+    n_ticks = si_time_ms_to_ticks(n_ms); 
 
     /* wait the calculated number of ticks */  
     time_handler_wait_n_ticks(n_ticks); 
@@ -99,6 +105,13 @@ void si_get_current_time(si_time *time)
     /* disable interrupts */ 
     DISABLE_INTERRUPTS; 
 
+    /* bring the time up to date, and let tasks 
+       whose waiting time has expired run */ 
+    if (tick_handler_update_time() > 0)
+    {
+        schedule(); 
+    }
+
     time_storage_get_current_time(time);
 
     /* enable interrupts */ 
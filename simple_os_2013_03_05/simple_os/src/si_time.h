@@ -23,6 +23,12 @@
 
 #include "si_time_type.h"
 
+/* results of timed and non-blocking calls, e.g. 
+   si_sem_wait_timed and si_sem_try_wait */ 
+#define SI_OK 0
+#define SI_TIMEOUT 1
+#define SI_WOULD_BLOCK 2
+
 /* si_wait_n_ms: makes the calling process wait 
    n_ms milliseconds */ 
 void si_wait_n_ms(int n_ms); 
@@ -31,5 +37,9 @@ void si_wait_until_time(si_time *time);
 
 void si_get_current_time(si_time *time); 
 
+/* si_time_ms_to_ticks: returns the number of ticks for 
+   waiting n_ms milliseconds, which is at least one */ 
+int si_time_ms_to_ticks(int n_ms); 
+
 #endif 
 
@@ -25,6 +25,8 @@
 #include "si_comm.h"
 
 #include "console.h"
+#include "tcb_storage.h"
+#include "tick_handler.h"
 
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
 
@@ -52,12 +54,36 @@ static char Message_String[SI_UI_MAX_MESSAGE_SIZE];
 /* command delimiter, which must be used also in the GUI client */ 
 static char Command_Delim; 
 
+/* buffer, and write position, for the reply to SI_UI_TOP_COMMAND */ 
+static char Top_Buffer[SI_UI_MESSAGE_BUFFER_SIZE]; 
+static int Top_Pos; 
+
+/* event where SI_UI_INPUT_FLAG is set when a message 
+   can be read, as checked when input arrives */ 
+static si_event Input_Event; 
+
+/* poll_input: sets SI_UI_INPUT_FLAG in Input_Event if a 
+   message can be read. Called at input interrupts, or at 
+   timer interrupts where input interrupts are not used. */ 
+static int poll_input(void)
+{
+    return si_comm_poll() ? 
+        si_event_set_bits(&Input_Event, SI_UI_INPUT_FLAG) : 0; 
+}
+
 /* si_ui_init: initialise communication */ 
 void si_ui_init(void)
 {
     Command_Delim = ';'; 
+    si_event_init(&Input_Event); 
     /* open communication channel */ 
     si_comm_open(); 
+    /* check for messages when input arrives, or else, 
+       e.g. on the Windows host, at timer interrupts */ 
+    if (!si_comm_set_input_function(poll_input))
+    {
+        tick_handler_set_poll_function(poll_input); 
+    }
     /* initialise message buffer semaphore */ 
     si_sem_init(&Si_Ui_Mutex, 1); 
     /* start writing at the beginning of the message buffer */
@@ -74,10 +100,10 @@ static void remove_trailing_command_delim(char buffer [])
     }
 }
 
-/* send_buffer: sends the contents of the message buffer 
+/* send_buffer: sends the contents of buffer 
    NOTE: it is assumed that the buffer is reserved when this function 
    is called */ 
-static void send_buffer(void)
+static void send_buffer(char buffer[])
 {
     int si_comm_return_value; 
 
@@ -85,14 +111,14 @@ static void send_buffer(void)
     const int max_n_tries = 10000; 
     const int delay_ms_between_tries = 100; 
 
-    remove_trailing_command_delim(Message_Buffer); 
+    remove_trailing_command_delim(buffer); 
 
     n_tries = 0; 
 
     do
     {
         /* write message buffer contents to communication channel */ 
-        si_comm_return_value = si_comm_write(Message_Buffer); 
+        si_comm_return_value = si_comm_write(buffer); 
 
         n_tries++; 
 
@@ -114,8 +140,9 @@ static void send_buffer(void)
     }
 }
 
-/* append_to_buffer: appends message to the message buffer */ 
-static void append_to_buffer(char message[])
+/* append_to_buffer: appends message to buffer, where the 
+   next message is written at position *pos */ 
+static void append_to_buffer(char buffer[], int *pos, char message[])
 {
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
     size_t i; 
@@ -127,28 +154,28 @@ static void append_to_buffer(char message[])
 
     for (i = 0; i < si_string_length(message) && !buffer_full; i++)
     {
-        Message_Buffer[Message_Pos] = message[i]; 
-        Message_Pos++; 
+        buffer[*pos] = message[i]; 
+        (*pos)++; 
         /* check if we are overflowing the buffer */ 
-        if (Message_Pos >= SI_UI_MESSAGE_BUFFER_SIZE - 1)
+        if (*pos >= SI_UI_MESSAGE_BUFFER_SIZE - 1)
         {
             console_put_string("NOTE: message buffer OVERFLOW\n"); 
             /* add string terminator */    
-            Message_Buffer[Message_Pos] = '\0'; 
+            buffer[*pos] = '\0'; 
             buffer_full = 1; 
             /* reset buffer, so that next write is from the buffer start position */ 
-            Message_Pos = 0; 
+            *pos = 0; 
         }
     }
 
     if (!buffer_full)
     {
         /* add command delimiter */ 
-        Message_Buffer[Message_Pos] = Command_Delim; 
-        Message_Pos++; 
+        buffer[*pos] = Command_Delim; 
+        (*pos)++; 
         /* add string terminator, in case no more strings are addded to the buffer */ 
-        Message_Buffer[Message_Pos] = '\0'; 
-        // printf("MB: %s\n", Message_Buffer); 
+        buffer[*pos] = '\0'; 
+        // printf("MB: %s\n", buffer); 
     }
 }
 
@@ -159,7 +186,7 @@ void si_ui_draw_begin(void)
     /* start from the beginning */ 
     Message_Pos = 0; 
         
-    append_to_buffer("draw_begin"); 
+    append_to_buffer(Message_Buffer, &Message_Pos, "draw_begin"); 
 
     si_sem_signal(&Si_Ui_Mutex); 
 }
@@ -168,15 +195,15 @@ void si_ui_draw_end(void)
 {
     si_sem_wait(&Si_Ui_Mutex); 
 
-    append_to_buffer("draw_end"); 
+    append_to_buffer(Message_Buffer, &Message_Pos, "draw_end"); 
 
     /* add a string containing only a newline, to keep the Java client happy, 
        NOTE: this may need to change, if problems occur e.g. when using a mix of 
        Windows and Linux */ 
-    append_to_buffer("\n"); 
+    append_to_buffer(Message_Buffer, &Message_Pos, "\n"); 
 
     /* send the buffer */ 
-    send_buffer(); 
+    send_buffer(Message_Buffer); 
 
     si_sem_signal(&Si_Ui_Mutex); 
 }
@@ -190,7 +217,7 @@ void si_ui_draw_string(char string[], int x_coord, int y_coord)
     si_insert_int_as_hex(Message_String, y_coord); 
     si_insert_string(Message_String, string); 
 
-    append_to_buffer(Message_String); 
+    append_to_buffer(Message_Buffer, &Message_Pos, Message_String); 
 
     si_sem_signal(&Si_Ui_Mutex); 
 }
@@ -204,7 +231,7 @@ void si_ui_draw_image(char image_name[], int x_coord, int y_coord)
     si_insert_int_as_hex(Message_String, x_coord); 
     si_insert_int_as_hex(Message_String, y_coord); 
 
-    append_to_buffer(Message_String); 
+    append_to_buffer(Message_Buffer, &Message_Pos, Message_String); 
 
     si_sem_signal(&Si_Ui_Mutex); 
 }
@@ -219,7 +246,7 @@ void si_ui_show_error(char message[])
     si_string_copy(Message_String, "show_error:%s"); 
     si_insert_string(Message_String, message); 
 
-    append_to_buffer(Message_String); 
+    append_to_buffer(Message_Buffer, &Message_Pos, Message_String); 
 
     si_sem_signal(&Si_Ui_Mutex); 
 
@@ -236,21 +263,82 @@ void si_ui_set_size(int x_size, int y_size)
     si_insert_int_as_hex(Message_String, x_size); 
     si_insert_int_as_hex(Message_String, y_size); 
 
-    append_to_buffer(Message_String); 
+    append_to_buffer(Message_Buffer, &Message_Pos, Message_String); 
 
     si_sem_signal(&Si_Ui_Mutex); 
 
     si_ui_draw_end(); 
 }
 
+/* send_top: sends the reply to SI_UI_TOP_COMMAND, with the 
+   CPU usage for the kernel and for each task. A separate 
+   buffer is used, so that drawing commands being prepared 
+   by other tasks are kept. 
+   NOTE: it is assumed that the communication link is reserved 
+   when this function is called */ 
+static void send_top(void)
+{
+    /* CPU usage for the kernel, and for a task */ 
+    si_kernel_stats kernel_stats; 
+    si_task_stats task_stats; 
+
+    int task_id; 
+
+    Top_Pos = 0; 
+
+    si_kernel_get_stats(&kernel_stats); 
+    si_string_copy(Message_String, "top_kernel:%x:%x:%x:%x"); 
+    si_insert_int_as_hex(Message_String, 
+        (int) (kernel_stats.elapsed_us / 1000)); 
+    si_insert_int_as_hex(Message_String, kernel_stats.idle_percent); 
+    si_insert_int_as_hex(Message_String, (int) kernel_stats.n_switches); 
+    si_insert_int_as_hex(Message_String, kernel_stats.n_tasks); 
+    append_to_buffer(Top_Buffer, &Top_Pos, Message_String); 
+
+    for (task_id = 0; task_id < TCB_LIST_SIZE; task_id++)
+    {
+        if (si_task_get_stats(task_id, &task_stats) != 0)
+        {
+            continue; 
+        }
+        si_string_copy(Message_String, "top_task:%x:%x:%x:%x:%x:%x:%x:%x"); 
+        si_insert_int_as_hex(Message_String, task_id); 
+        si_insert_int_as_hex(Message_String, task_stats.priority); 
+        si_insert_int_as_hex(Message_String, task_stats.is_idle); 
+        si_insert_int_as_hex(Message_String, 
+            (int) (task_stats.run_time_us / 1000)); 
+        si_insert_int_as_hex(Message_String, task_stats.run_percent); 
+        si_insert_int_as_hex(Message_String, task_stats.n_switches); 
+        si_insert_int_as_hex(Message_String, task_stats.n_voluntary); 
+        si_insert_int_as_hex(Message_String, task_stats.n_preempted); 
+        append_to_buffer(Top_Buffer, &Top_Pos, Message_String); 
+    }
+
+    append_to_buffer(Top_Buffer, &Top_Pos, "top_end"); 
+    /* end with a newline, as for si_ui_draw_end */ 
+    append_to_buffer(Top_Buffer, &Top_Pos, "\n"); 
+
+    send_buffer(Top_Buffer); 
+}
+
+si_event *si_ui_get_input_event(void)
+{
+    return &Input_Event; 
+}
+
 void si_ui_receive(char message[])
 {
+    /* the input event, as the only object to wait for */ 
+    si_wait_item item; 
+
     int si_comm_return_value; 
 
+    /* nonzero when SI_UI_TOP_COMMAND has been received */ 
+    int is_top_command; 
+
     int n_tries; 
 
     const int max_n_tries = 10000; 
-    const int delay_ms_between_tries = 250; 
 
     n_tries = 0; 
 
@@ -262,14 +350,28 @@ void si_ui_receive(char message[])
 
         n_tries++; 
 
-        /* wait and let other tasks try if reading is not ok */ 
+        /* reply to SI_UI_TOP_COMMAND, and continue reading */ 
+        is_top_command = si_comm_return_value == SI_COMM_OK && 
+            si_string_compare(message, SI_UI_TOP_COMMAND) == 0; 
+        if (is_top_command)
+        {
+            send_top(); 
+            n_tries = 0; 
+        }
+
+        /* wait for input, and let other tasks try, if 
+           reading is not ok */ 
         if (si_comm_return_value != SI_COMM_OK)
         {
             si_sem_signal(&Si_Ui_Mutex); 
-            si_wait_n_ms(delay_ms_between_tries); 
+            item.type = SI_WAIT_EVENT; 
+            item.object = &Input_Event; 
+            item.mask = SI_UI_INPUT_FLAG; 
+            si_wait_any(&item, 1, SI_WAIT_FOREVER); 
             si_sem_wait(&Si_Ui_Mutex); 
         }
-    } while (n_tries < max_n_tries && si_comm_return_value != SI_COMM_OK); 
+    } while (is_top_command || 
+             (n_tries < max_n_tries && si_comm_return_value != SI_COMM_OK)); 
 
     if (si_comm_return_value != SI_COMM_OK)
     {
@@ -21,8 +21,13 @@
 #ifndef SI_UI_H
 #define SI_UI_H
 
+#include "si_event.h"
+
 #define SI_UI_MAX_MESSAGE_SIZE 1000
 
+/* the flag set in the event returned by si_ui_get_input_event */ 
+#define SI_UI_INPUT_FLAG 1
+
 /* si_ui_init: initialise communication */ 
 void si_ui_init(void); 
 
@@ -53,11 +58,30 @@ void si_ui_show_error(char message[]);
 void si_ui_set_size(int x_size, int y_size); 
 
 
+/* the message which requests the CPU usage. It is handled 
+   by si_ui_receive, which replies with the commands 
+   top_kernel:elapsed_ms:idle_percent:n_switches:n_tasks, 
+   then for each task 
+   top_task:task_id:priority:is_idle:run_ms:run_percent:
+   n_switches:n_voluntary:n_preempted, and finally top_end, 
+   with the numbers in hex. See si_kernel_get_stats and 
+   si_task_get_stats. */ 
+#define SI_UI_TOP_COMMAND "top"
+
 /* si_ui_receive: receives a message in message. 
    It is assumed that the message array is of size 
-   SI_UI_MAX_MESSAGE_SIZE */ 
+   SI_UI_MAX_MESSAGE_SIZE. SI_UI_TOP_COMMAND is answered 
+   here, and is not returned. */ 
 void si_ui_receive(char message[]); 
 
+/* si_ui_get_input_event: returns an event where SI_UI_INPUT_FLAG 
+   is set when a message can be received. On the Linux host, the 
+   event is set when input arrives, and on the Windows host, at 
+   a timer interrupt. A task can wait for the event, and e.g. its 
+   mailbox, using si_wait_any, and then call si_ui_receive. The 
+   event is not set on the target. */ 
+si_event *si_ui_get_input_event(void); 
+
 void si_ui_close(void); 
 
 #endif
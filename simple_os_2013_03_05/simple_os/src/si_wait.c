@@ -0,0 +1,160 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+#include "si_wait.h"
+
+#include "wait_any.h"
+#include "interrupt.h"
+#include "task.h"
+#include "ready_list.h"
+#include "schedule.h"
+#include "si_semaphore.h"
+#include "si_event.h"
+#include "si_message.h"
+#include "si_time.h"
+#include "time_handler.h"
+
+/* take_item: takes the object of item, if it is available. 
+   Returns nonzero if the object was taken. */ 
+static int take_item(si_wait_item *item)
+{
+    switch (item->type)
+    {
+    case SI_WAIT_SEMAPHORE: 
+        return si_sem_take((si_semaphore *) item->object); 
+    case SI_WAIT_EVENT: 
+        item->bits = si_event_take((si_event *) item->object, item->mask); 
+        return item->bits != 0; 
+    case SI_WAIT_MESSAGE: 
+        return si_message_is_available(); 
+    default: 
+        return 0; 
+    }
+}
+
+/* get_wait_any_list: returns the list where the calling 
+   task waits for the object of item, or 0 */ 
+static wait_any_list_type *get_wait_any_list(si_wait_item *item)
+{
+    switch (item->type)
+    {
+    case SI_WAIT_SEMAPHORE: 
+        return &((si_semaphore *) item->object)->wait_any_list; 
+    case SI_WAIT_EVENT: 
+        return &((si_event *) item->object)->wait_any_list; 
+    case SI_WAIT_MESSAGE: 
+        return si_message_get_wait_any_list(); 
+    default: 
+        return 0; 
+    }
+}
+
+/* take_first: takes the first available object in items. 
+   Returns its index, or -1 if no object is available. */ 
+static int take_first(si_wait_item items[], int n_items)
+{
+    int i; 
+
+    for (i = 0; i < n_items; i++)
+    {
+        if (take_item(&items[i]))
+        {
+            return i; 
+        }
+    }
+    return -1; 
+}
+
+int si_wait_any(si_wait_item items[], int n_items, int timeout_ms)
+{
+    /* the nodes by which the calling task waits */ 
+    wait_any_node_type nodes[SI_WAIT_MAX_ITEMS]; 
+    int n_nodes; 
+    /* the list for an object */ 
+    wait_any_list_type *wait_any_list; 
+    /* the timeout, in ticks */ 
+    int n_ticks; 
+    /* the tick at which the timeout expires */ 
+    unsigned int expiry_tick = 0; 
+    /* the index of the selected object */ 
+    int result; 
+    int task_id; 
+    int i; 
+
+    if (n_items < 1 || n_items > SI_WAIT_MAX_ITEMS)
+    {
+        return -1; 
+    }
+    if (timeout_ms < 0)
+    {
+        n_ticks = TIME_HANDLER_WAIT_FOREVER; 
+    }
+    else
+    {
+        n_ticks = timeout_ms > 0 ? si_time_ms_to_ticks(timeout_ms) : 0; 
+    }
+
+    DISABLE_INTERRUPTS; 
+
+    task_id = task_get_task_id_running(); 
+    if (n_ticks > 0)
+    {
+        expiry_tick = time_handler_get_expiry_tick(n_ticks); 
+    }
+    result = take_first(items, n_items); 
+    while (result < 0 && n_ticks != 0)
+    {
+        /* wait in the list of each object */ 
+        n_nodes = 0; 
+        for (i = 0; i < n_items; i++)
+        {
+            wait_any_list = get_wait_any_list(&items[i]); 
+            if (wait_any_list != 0)
+            {
+                wait_any_list_insert(wait_any_list, &nodes[n_nodes], task_id); 
+                n_nodes++; 
+            }
+        }
+        wait_any_set_nodes(task_id, nodes, n_nodes); 
+        ready_list_remove(task_id); 
+        if (n_ticks != TIME_HANDLER_WAIT_FOREVER)
+        {
+            time_handler_start_timeout(n_ticks); 
+        }
+        schedule(); 
+        wait_any_remove_nodes(task_id); 
+
+        /* an object may have been taken by another task, 
+           and the calling task then waits again, for the 
+           remaining part of the timeout */ 
+        result = take_first(items, n_items); 
+        if (n_ticks != TIME_HANDLER_WAIT_FOREVER)
+        {
+            if (time_handler_has_timed_out())
+            {
+                break; 
+            }
+            n_ticks = time_handler_get_ticks_left(expiry_tick); 
+        }
+    }
+
+    ENABLE_INTERRUPTS; 
+
+    return result; 
+}
@@ -0,0 +1,66 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+#ifndef SI_WAIT_H
+#define SI_WAIT_H
+
+/* types of objects for si_wait_any */ 
+#define SI_WAIT_SEMAPHORE 0
+#define SI_WAIT_EVENT 1
+#define SI_WAIT_MESSAGE 2
+
+/* value of timeout_ms for si_wait_any, to indicate 
+   that there is no timeout */ 
+#define SI_WAIT_FOREVER -1
+
+/* the largest number of objects for si_wait_any, which 
+   may be set at compile time */ 
+#ifndef SI_WAIT_MAX_ITEMS
+#define SI_WAIT_MAX_ITEMS 8
+#endif
+
+/* an object for si_wait_any */ 
+typedef struct
+{
+    /* the type of the object, e.g. SI_WAIT_SEMAPHORE */ 
+    int type; 
+    /* a pointer to the si_semaphore or si_event, 
+       or 0 for SI_WAIT_MESSAGE */ 
+    void *object; 
+    /* for SI_WAIT_EVENT, the flags to wait for, and the 
+       flags which were set, and cleared, by si_wait_any */ 
+    unsigned int mask; 
+    unsigned int bits; 
+} si_wait_item; 
+
+/* si_wait_any: waits until one of the n_items objects in items 
+   is available, or at most timeout_ms milliseconds, where 0 
+   means that the calling task does not wait, and SI_WAIT_FOREVER 
+   that there is no timeout. A semaphore is available when its 
+   value is positive, and is then decremented, as by si_sem_wait. 
+   An event is available when any of its flags in mask is set, 
+   and the set flags are cleared and stored in bits. A message 
+   is available when the calling task has a message, or a 
+   request, which it then receives without waiting. When several 
+   objects are available, the first in items is selected. Returns 
+   the index in items of the selected object, or -1 if the timeout 
+   expired, or n_items is not in the range 1 .. SI_WAIT_MAX_ITEMS. */ 
+int si_wait_any(si_wait_item items[], int n_items, int timeout_ms); 
+
+#endif
@@ -23,9 +23,14 @@
 
 #include "si_kernel.h"
 #include "si_time.h"
+#include "si_periodic.h"
 #include "si_semaphore.h"
+#include "si_mutex.h"
 #include "si_condvar.h"
+#include "si_pool.h"
 #include "si_message.h"
+#include "si_event.h"
+#include "si_wait.h"
 #include "si_ui.h"
 #include "si_string_lib.h"
 #include "console.h"
@@ -0,0 +1,232 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "smp.h"
+
+#ifdef SMP_HOST
+
+#include "task.h"
+#include "tcb.h"
+#include "tcb_storage.h"
+#include "task_id_list.h"
+#include "schedule.h"
+#include "idle.h"
+#include "timer.h"
+#include "interrupt.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+/* number of attempts to take the kernel lock, 
+   before the CPU yields to other host threads */ 
+#define SMP_LOCK_SPIN_COUNT 1000
+
+/* the id of the CPU, for each host thread */ 
+static __thread int Cpu_Id; 
+
+/* the host threads */ 
+static pthread_t Cpu_Thread[SMP_N_CPUS]; 
+
+/* the idle task for each CPU */ 
+static int Idle_Task_Id[SMP_N_CPUS]; 
+
+/* nonzero for an idle CPU which has been interrupted, and 
+   not yet scheduled, so that the next ready task is given 
+   to another idle CPU */ 
+static int Cpu_Kicked[SMP_N_CPUS]; 
+
+/* nonzero when all CPUs have been started */ 
+static int Cpus_Started; 
+
+/* the kernel lock, and the CPU holding it, or -1 */ 
+static volatile int Kernel_Lock; 
+static volatile int Kernel_Lock_Cpu; 
+
+/* interrupt_signals: sets *set to the signals used as interrupts */ 
+static void interrupt_signals(sigset_t *set)
+{
+    sigemptyset(set); 
+    sigaddset(set, TIMER_SIGNAL); 
+    sigaddset(set, INPUT_SIGNAL); 
+    sigaddset(set, SMP_IPI_SIGNAL); 
+}
+
+/* ipi_handler: handles an interrupt from another CPU, 
+   by letting an idle CPU wake up, and scheduling */ 
+static void ipi_handler(int signal)
+{
+    smp_lock(); 
+    idle_register_interrupt(); 
+    Cpu_Kicked[Cpu_Id] = 0; 
+    schedule(); 
+    smp_unlock(); 
+}
+
+/* cpu_thread: the host thread for a CPU other than CPU 0 */ 
+static void *cpu_thread(void *arg)
+{
+    Cpu_Id = (int) (long) arg; 
+
+    /* interrupts are blocked, as inherited from CPU 0, 
+       and are unblocked when the idle task starts */ 
+    smp_lock(); 
+    task_start(Idle_Task_Id[Cpu_Id]); 
+
+    /* will never be here! */ 
+    return NULL; 
+}
+
+void smp_init(void)
+{
+    int cpu; 
+
+    Cpu_Id = 0; 
+    for (cpu = 0; cpu < SMP_N_CPUS; cpu++)
+    {
+        Cpu_Kicked[cpu] = 0; 
+    }
+    Cpu_Thread[0] = pthread_self(); 
+    Cpus_Started = 0; 
+    Kernel_Lock = 0; 
+    Kernel_Lock_Cpu = -1; 
+    smp_set_interrupt_handler(SMP_IPI_SIGNAL, ipi_handler); 
+}
+
+void smp_set_idle_task(int cpu, int task_id)
+{
+    Idle_Task_Id[cpu] = task_id; 
+    tcb_storage_get_tcb_ref(task_id)->cpu = cpu; 
+}
+
+void smp_start(void)
+{
+    long cpu; 
+    for (cpu = 1; cpu < SMP_N_CPUS; cpu++)
+    {
+        pthread_create(&Cpu_Thread[cpu], NULL, cpu_thread, (void *) cpu); 
+    }
+    Cpus_Started = 1; 
+}
+
+int smp_get_cpu_id(void)
+{
+    return Cpu_Id; 
+}
+
+void smp_block_interrupts(void)
+{
+    sigset_t set; 
+    interrupt_signals(&set); 
+    pthread_sigmask(SIG_BLOCK, &set, NULL); 
+}
+
+void smp_unblock_interrupts(void)
+{
+    sigset_t set; 
+    interrupt_signals(&set); 
+    pthread_sigmask(SIG_UNBLOCK, &set, NULL); 
+}
+
+void smp_lock(void)
+{
+    /* number of attempts to take the lock */ 
+    int n_spins = 0; 
+
+    if (Kernel_Lock_Cpu == Cpu_Id)
+    {
+        return; 
+    }
+    while (__sync_lock_test_and_set(&Kernel_Lock, 1))
+    {
+        while (Kernel_Lock)
+        {
+            if (++n_spins == SMP_LOCK_SPIN_COUNT)
+            {
+                /* let the holder run, if it shares a host core */ 
+                sched_yield(); 
+                n_spins = 0; 
+            }
+        }
+    }
+    Kernel_Lock_Cpu = Cpu_Id; 
+}
+
+void smp_unlock(void)
+{
+    if (Kernel_Lock_Cpu != Cpu_Id)
+    {
+        return; 
+    }
+    Kernel_Lock_Cpu = -1; 
+    __sync_lock_release(&Kernel_Lock); 
+}
+
+void smp_set_interrupt_handler(int signal, void (*handler)(int))
+{
+    struct sigaction action; 
+
+    memset(&action, 0, sizeof(action)); 
+    action.sa_handler = handler; 
+    interrupt_signals(&action.sa_mask); 
+    action.sa_flags = SA_RESTART; 
+    sigaction(signal, &action, NULL); 
+}
+
+void smp_notify_ready(int task_id)
+{
+    /* the priority of the task */ 
+    int priority = tcb_storage_get_tcb_ref(task_id)->priority; 
+    /* the CPU of the task */ 
+    int cpu = tcb_storage_get_tcb_ref(task_id)->cpu; 
+    /* the task running on a CPU */ 
+    int task_id_running; 
+
+    if (!Cpus_Started)
+    {
+        return; 
+    }
+
+    /* the calling CPU schedules by itself */ 
+    if (cpu != Cpu_Id)
+    {
+        task_id_running = task_get_task_id_running_on(cpu); 
+        if (priority < tcb_storage_get_tcb_ref(task_id_running)->priority)
+        {
+            /* the task shall preempt the running task */ 
+            pthread_kill(Cpu_Thread[cpu], SMP_IPI_SIGNAL); 
+            return; 
+        }
+    }
+
+    /* let an idle CPU take the task, or the task it preempts */ 
+    for (cpu = 0; cpu < SMP_N_CPUS; cpu++)
+    {
+        if (cpu != Cpu_Id && !Cpu_Kicked[cpu] && 
+            task_get_task_id_running_on(cpu) == Idle_Task_Id[cpu])
+        {
+            Cpu_Kicked[cpu] = 1; 
+            pthread_kill(Cpu_Thread[cpu], SMP_IPI_SIGNAL); 
+            return; 
+        }
+    }
+}
+
+#endif
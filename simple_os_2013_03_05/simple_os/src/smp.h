@@ -0,0 +1,101 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef SMP_H
+#define SMP_H
+
+/* Simple_OS runs on one CPU, unless SMP_HOST is defined, e.g. 
+   by -DSMP_HOST. Then, on the Linux host, SMP_N_CPUS threads 
+   act as virtual CPUs. Each CPU has its own ready list and 
+   running task, and a CPU with no task of higher priority 
+   than its current best task takes a ready task from another 
+   CPU. Kernel data is protected by a kernel lock, which is 
+   taken when interrupts are disabled. Timer interrupts are 
+   handled by CPU 0, which is the thread calling si_kernel_init, 
+   and time slicing applies to the tasks running on CPU 0. */ 
+
+#ifdef SMP_HOST
+
+#if !defined BUILD_X86_HOST && !defined BUILD_X86_64_HOST
+#error "SMP_HOST requires a Linux host build"
+#endif
+
+#ifdef EDF_SCHEDULING
+#error "SMP_HOST can not be combined with EDF_SCHEDULING"
+#endif
+
+#include <signal.h>
+
+/* number of CPUs, which may be set at compile 
+   time, e.g. by -DSMP_N_CPUS=8 */ 
+#ifndef SMP_N_CPUS
+#define SMP_N_CPUS 4
+#endif
+
+/* the signal used for interrupts from one CPU to another */ 
+#define SMP_IPI_SIGNAL SIGUSR2
+
+/* smp_init: perform initialisation, making the 
+   calling thread CPU 0 */ 
+void smp_init(void); 
+
+/* smp_set_idle_task: registers task_id as the idle task for cpu, 
+   and makes cpu the CPU for the task */ 
+void smp_set_idle_task(int cpu, int task_id); 
+
+/* smp_start: starts the CPUs other than CPU 0, where each 
+   CPU starts its idle task */ 
+void smp_start(void); 
+
+/* smp_get_cpu_id: returns the id of the calling CPU */ 
+int smp_get_cpu_id(void); 
+
+/* smp_block_interrupts and smp_unblock_interrupts: block and 
+   unblock interrupts on the calling CPU, without the kernel lock */ 
+void smp_block_interrupts(void); 
+void smp_unblock_interrupts(void); 
+
+/* smp_lock: takes the kernel lock. Nothing is done if 
+   the calling CPU holds the lock already. */ 
+void smp_lock(void); 
+
+/* smp_unlock: releases the kernel lock, if held by the calling CPU */ 
+void smp_unlock(void); 
+
+/* smp_set_interrupt_handler: installs handler for signal, 
+   with the interrupt signals blocked while handler runs */ 
+void smp_set_interrupt_handler(int signal, void (*handler)(int)); 
+
+/* smp_notify_ready: called when task_id has been inserted in 
+   the ready list. Interrupts the CPU of the task, if the task 
+   shall run there, and otherwise an idle CPU, which then may 
+   take the task. */ 
+void smp_notify_ready(int task_id); 
+
+#else
+
+/* one CPU */ 
+#define SMP_N_CPUS 1
+
+#define smp_get_cpu_id() 0
+
+#endif
+
+#endif
@@ -0,0 +1,155 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "stack_arena.h"
+
+#if (defined BUILD_X86_HOST || defined BUILD_X86_64_HOST) && \
+    !defined BUILD_X86_WIN_HOST
+#define STACK_ARENA_GUARD
+#endif
+
+#ifdef STACK_ARENA_GUARD
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/* the number of size classes, where size class c holds 
+   stacks of 2^c granules */ 
+#define STACK_ARENA_N_CLASSES 20
+
+#ifdef STACK_ARENA_GUARD
+
+/* the arena, which is reserved when the first stack is allocated */ 
+static char *Arena = 0; 
+
+/* the size of a granule, which is one page */ 
+static long Granule_Size; 
+
+#else
+
+/* the arena */ 
+static stack_item Arena_Items[STACK_ARENA_SIZE / sizeof(stack_item)]; 
+static char *Arena = (char *) Arena_Items; 
+
+/* the size of a granule */ 
+static long Granule_Size = 1024; 
+
+#endif
+
+/* the amount of the arena, in bytes, from which stacks have been 
+   allocated, and which thus is used or stored in Free_List */ 
+static long Arena_Used; 
+
+/* for each size class, the first free stack, where each free 
+   stack stores a pointer to the next free stack at its lowest 
+   stack item */ 
+static stack_item *Free_List[STACK_ARENA_N_CLASSES]; 
+
+void stack_arena_init(void)
+{
+    int c; 
+
+    Arena_Used = 0; 
+    for (c = 0; c < STACK_ARENA_N_CLASSES; c++)
+    {
+        Free_List[c] = 0; 
+    }
+}
+
+/* size_class: returns the size class for stacks 
+   of n_bytes bytes, or -1 if there is none */ 
+static int size_class(long n_bytes)
+{
+    int c = 0; 
+
+    while (c < STACK_ARENA_N_CLASSES && (Granule_Size << c) < n_bytes)
+    {
+        c++; 
+    }
+    return c < STACK_ARENA_N_CLASSES ? c : -1; 
+}
+
+stack_item *stack_arena_alloc(int stack_size, int *alloc_size)
+{
+    /* the size class, and the allocated stack */ 
+    int c; 
+    stack_item *stack; 
+    /* the size of the stack, including a guard page */ 
+    long chunk_size; 
+
+#ifdef STACK_ARENA_GUARD
+    if (Arena == 0)
+    {
+        Granule_Size = sysconf(_SC_PAGESIZE); 
+        Arena = mmap(0, STACK_ARENA_SIZE, PROT_READ | PROT_WRITE, 
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0); 
+        if (Arena == MAP_FAILED)
+        {
+            Arena = 0; 
+            return 0; 
+        }
+    }
+#endif
+
+    c = size_class((long) stack_size * sizeof(stack_item)); 
+    if (c < 0)
+    {
+        return 0; 
+    }
+    *alloc_size = (Granule_Size << c) / sizeof(stack_item); 
+
+    /* reuse a free stack, if there is one */ 
+    if (Free_List[c] != 0)
+    {
+        stack = Free_List[c]; 
+        Free_List[c] = *(stack_item **) stack; 
+        return stack; 
+    }
+
+    /* allocate a new stack from the unused part of the arena */ 
+    chunk_size = Granule_Size << c; 
+#ifdef STACK_ARENA_GUARD
+    chunk_size += Granule_Size; 
+#endif
+    if (Arena_Used + chunk_size > STACK_ARENA_SIZE)
+    {
+        return 0; 
+    }
+    stack = (stack_item *) (Arena + Arena_Used + chunk_size - (Granule_Size << c)); 
+#ifdef STACK_ARENA_GUARD
+    /* the guard page is below the stack, and stays 
+       inaccessible when the stack is reused */ 
+    if (mprotect(Arena + Arena_Used, Granule_Size, PROT_NONE) != 0)
+    {
+        return 0; 
+    }
+#endif
+    Arena_Used += chunk_size; 
+    return stack; 
+}
+
+void stack_arena_free(stack_item *stack, int alloc_size)
+{
+    /* the size class */ 
+    int c = size_class((long) alloc_size * sizeof(stack_item)); 
+
+    *(stack_item **) stack = Free_List[c]; 
+    Free_List[c] = stack; 
+}
@@ -0,0 +1,54 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef STACK_ARENA_H
+#define STACK_ARENA_H
+
+#include "arch_types.h"
+
+/* size of the memory, in bytes, from which stacks are allocated, 
+   which may be set at compile time, e.g. by -DSTACK_ARENA_SIZE=65536. 
+   On Linux hosts, the memory is reserved using mmap, and each stack 
+   is preceded by an inaccessible guard page, so that a stack 
+   overflow causes a segmentation fault. */ 
+#ifndef STACK_ARENA_SIZE
+#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
+#define STACK_ARENA_SIZE (256L * 1024L * 1024L)
+#else
+#define STACK_ARENA_SIZE (64L * 1024L)
+#endif
+#endif
+
+/* stack_arena_init: initialise the stack arena, so that 
+   all memory is free */ 
+void stack_arena_init(void); 
+
+/* stack_arena_alloc: allocates a stack of at least stack_size 
+   stack items, and returns its lowest stack item, or 0 if there 
+   is no free memory. The usable size of the stack, in stack items, 
+   is stored in *alloc_size, and shall be given when the stack 
+   is freed. */ 
+stack_item *stack_arena_alloc(int stack_size, int *alloc_size); 
+
+/* stack_arena_free: frees the stack stack, of usable size 
+   alloc_size, as returned by stack_arena_alloc */ 
+void stack_arena_free(stack_item *stack, int alloc_size); 
+
+#endif
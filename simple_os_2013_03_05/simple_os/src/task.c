@@ -23,23 +23,121 @@
 #include "arch_types.h"
 #include "tcb.h"
 #include "tcb_storage.h"
+#include "task_id_list.h"
 #include "context.h"
 #include "exceptions.h"
 #include "console.h"
 #include "int_status.h"
 #include "interrupt.h"
+#include "fpu.h"
+#include "smp.h"
+#include "timer.h"
+#include "stack_arena.h"
 
-/* the running task */ 
-static int Task_Id_Running; 
+#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
+#include <stdlib.h>
+#endif
+
+/* the running task, for each CPU */ 
+static int Task_Id_Running[SMP_N_CPUS]; 
+
+/* the total number of task switches */ 
+static long Task_N_Switches; 
+
+/* the first task which has exited, but whose TCB and stack 
+   have not been freed, linked using the next_task_id field */ 
+static int Task_Exited_First; 
+
+/* the value stored in unused parts of a stack, which is 
+   created by task_create_stack, and the value of the canary 
+   stored at the stack limit */ 
+#define STACK_FILL_PATTERN ((stack_item) 0x5A5A5A5A)
+#define STACK_CANARY ((stack_item) 0x0BADCAFE)
+
+long long task_get_time_ns(void)
+{
+#ifdef TIMER_CLOCK
+    return timer_get_time_ns(); 
+#else
+    return 0; 
+#endif
+}
+
+/* record_latency: adds latency_ns to the wakeup 
+   latency statistics in *tcb_ref */ 
+static void record_latency(task_control_block *tcb_ref, long long latency_ns)
+{
+    /* the latency in microseconds, and its bucket */ 
+    long long latency_us = latency_ns / 1000; 
+    int bucket = 0; 
+
+    while (latency_us > 0 && bucket < LATENCY_N_BUCKETS - 1)
+    {
+        latency_us >>= 1; 
+        bucket++; 
+    }
+    tcb_ref->latency_histogram[bucket]++; 
+    tcb_ref->n_latencies++; 
+    tcb_ref->sum_latency_ns += latency_ns; 
+    if (latency_ns > tcb_ref->max_latency_ns)
+    {
+        tcb_ref->max_latency_ns = latency_ns; 
+    }
+}
+
+/* account_switch: updates the CPU accounting when 
+   task_id_new starts running instead of task_id_old, 
+   at the time now_ns. task_id_old is TASK_ID_INVALID 
+   when no task has run before. */ 
+static void account_switch(int task_id_old, int task_id_new, long long now_ns)
+{
+    task_control_block *tcb_ref; 
+
+    if (task_id_old != TASK_ID_INVALID)
+    {
+        tcb_ref = tcb_storage_get_tcb_ref(task_id_old); 
+        tcb_ref->run_time_ns += now_ns - tcb_ref->switch_in_ns; 
+        /* a task which is still ready has been preempted */ 
+        if (tcb_ref->is_ready)
+        {
+            tcb_ref->n_preempted++; 
+        }
+        else
+        {
+            tcb_ref->n_voluntary++; 
+        }
+    }
+    tcb_ref = tcb_storage_get_tcb_ref(task_id_new); 
+    tcb_ref->switch_in_ns = now_ns; 
+    tcb_ref->n_switches++; 
+    Task_N_Switches++; 
+    if (tcb_ref->latency_pending)
+    {
+        record_latency(tcb_ref, now_ns - tcb_ref->ready_ns); 
+        tcb_ref->latency_pending = 0; 
+    }
+}
 
 void task_init(void)
 {
+    /* loop counter */ 
+    int cpu; 
+
     /* initialise list of all TCBs */ 
     tcb_storage_init(); 
+    /* no task has a private FPU context */ 
+    fpu_init(); 
 #ifdef BUILD_ARM_BB
     setup_swi_handler((mem_address) context_switch); 
 #endif
-    Task_Id_Running = -1; 
+    for (cpu = 0; cpu < SMP_N_CPUS; cpu++)
+    {
+        Task_Id_Running[cpu] = -1; 
+    }
+    Task_N_Switches = 0; 
+    Task_Exited_First = TASK_ID_INVALID; 
+    /* all stacks for task_create_auto are free */ 
+    stack_arena_init(); 
 }
 
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
@@ -51,6 +149,22 @@ static void enable_int_function(void)
 
 #endif
 
+#ifdef BUILD_X86_64_HOST
+/* context_align: returns to the task function, defined 
+   in arch/x86_64_host/context.s */ 
+void context_align(void); 
+#endif
+
+#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
+/* the function to which a task function returns */ 
+static void (*Task_Return_Function)(void); 
+
+void task_set_return_function(void (*return_function)(void))
+{
+    Task_Return_Function = return_function; 
+}
+#endif
+
 /* fig_begin prepare_stack_arm */ 
 static void prepare_stack(
     stack_item *stack, mem_address *sp, 
@@ -59,6 +173,21 @@ static void prepare_stack(
 {
     int i;
     stack_item *stack_ref; 
+#ifdef BUILD_X86_HOST
+    /* the task function returns to Task_Return_Function */ 
+    stack[0] = (stack_item) Task_Return_Function; 
+    stack--; 
+#endif
+#ifdef BUILD_X86_64_HOST
+    /* the task function shall be entered with the stack 
+       aligned to 16 bytes, before its return address, as 
+       required by the System V AMD64 ABI. The task function 
+       returns via context_align to Task_Return_Function, 
+       which then is entered with the same alignment. */ 
+    stack = (stack_item *) ((long) (stack - 2) & ~15L); 
+    stack[1] = (stack_item) context_align; 
+    stack[2] = (stack_item) Task_Return_Function; 
+#endif
     stack_ref = stack; 
 /* fig_begin prepare_stack_code_arm */ 
     *stack_ref = (stack_item) task_function; 
@@ -74,6 +203,12 @@ static void prepare_stack(
 /* fig_end prepare_stack_code_arm */ 
 /* fig_end prepare_stack_arm */ 
 #endif 
+#ifdef BUILD_X86_64_HOST
+    /* enable_int_function returns via context_align, 
+       and context_align returns to task_function */ 
+    stack_ref--; 
+    *stack_ref = (stack_item) context_align; 
+#endif
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
     stack_ref--; 
     *stack_ref = (stack_item) enable_int_function; 
@@ -97,7 +232,7 @@ static void prepare_stack(
     *sp -= 4; 
 #endif
 #if defined BUILD_X86_64_HOST
-    *sp -= 8; 
+    *sp -= 16; 
 #endif
 /* fig_begin prepare_stack_arm */ 
     *sp -= n_saved_registers * n_bytes_per_register; 
@@ -121,7 +256,7 @@ int task_create(
     int n_bytes_per_register = 4; 
 #endif
 #ifdef BUILD_X86_64_HOST
-    int n_saved_registers = 5; 
+    int n_saved_registers = 6; 
     int n_bytes_per_register = 8; 
 #endif
 #ifdef BUILD_X86_MAC_HOST
@@ -129,11 +264,16 @@ int task_create(
     int n_bytes_per_register = 8; 
 #endif
 
+    /* free the TCBs and stacks of exited tasks, so that they can be reused */ 
+    task_reap(); 
+
     prepare_stack(stack_bottom, &task_sp, task_function, 
 		  n_saved_registers, n_bytes_per_register); 
 
     /* initialise the tcb */ 
     tcb_init(&tcb, task_sp, priority); 
+    /* the task is stored in the ready list of the calling CPU */ 
+    tcb.cpu = smp_get_cpu_id(); 
 
     /* install the tcb */ 
     task_id = tcb_storage_install_tcb(tcb); 
@@ -142,9 +282,200 @@ int task_create(
     return task_id; 
 }
 
+int task_create_stack(
+    void (*task_function)(void), 
+    stack_item stack[], int stack_size, int priority)
+{
+    int task_id;            /* task id */ 
+    int i;                  /* loop counter */ 
+
+    /* fill the stack, so that the used part can be found, 
+       and store the canary at the limit */ 
+    for (i = 1; i < stack_size; i++)
+    {
+        stack[i] = STACK_FILL_PATTERN; 
+    }
+    stack[0] = STACK_CANARY; 
+
+    task_id = task_create(task_function, &stack[stack_size-1], priority); 
+
+    if (task_id != TASK_ID_INVALID)
+    {
+        tcb_storage_get_tcb_ref(task_id)->stack_limit = stack; 
+        tcb_storage_get_tcb_ref(task_id)->stack_size = stack_size; 
+    }
+    return task_id; 
+}
+
+int task_create_auto(
+    void (*task_function)(void), int stack_size, int priority)
+{
+    int task_id;            /* task id */ 
+    stack_item *stack;      /* the allocated stack */ 
+    int alloc_size;         /* the size of the allocated stack */ 
+
+    task_reap(); 
+
+    stack = stack_arena_alloc(stack_size, &alloc_size); 
+    if (stack == 0)
+    {
+        return TASK_ID_INVALID; 
+    }
+
+    /* the stack is checked as for task_create_stack */ 
+    task_id = task_create_stack(task_function, stack, alloc_size, priority); 
+
+    if (task_id == TASK_ID_INVALID)
+    {
+        stack_arena_free(stack, alloc_size); 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(task_id)->arena_stack = stack; 
+        tcb_storage_get_tcb_ref(task_id)->arena_stack_size = alloc_size; 
+    }
+    return task_id; 
+}
+
+int task_is_running(int task_id)
+{
+    int cpu; 
+
+    for (cpu = 0; cpu < SMP_N_CPUS; cpu++)
+    {
+        if (Task_Id_Running[cpu] == task_id)
+        {
+            return 1; 
+        }
+    }
+    return 0; 
+}
+
+void task_delete(int task_id)
+{
+    /* a pointer to the TCB for task_id */ 
+    task_control_block *tcb_ref = tcb_storage_get_tcb_ref(task_id); 
+
+    if (task_is_running(task_id))
+    {
+        /* free the TCB and the stack when the task has stopped running */ 
+        tcb_ref->has_exited = 1; 
+        tcb_ref->next_task_id = Task_Exited_First; 
+        Task_Exited_First = task_id; 
+        return; 
+    }
+    if (tcb_ref->arena_stack != 0)
+    {
+        stack_arena_free(tcb_ref->arena_stack, tcb_ref->arena_stack_size); 
+    }
+    fpu_task_release(task_id); 
+    tcb_storage_free_tcb(task_id); 
+}
+
+void task_reap(void)
+{
+    /* the link to the current exited task */ 
+    int *link = &Task_Exited_First; 
+    /* the current exited task */ 
+    int task_id; 
+
+    while (*link != TASK_ID_INVALID)
+    {
+        task_id = *link; 
+        if (task_is_running(task_id))
+        {
+            link = &tcb_storage_get_tcb_ref(task_id)->next_task_id; 
+        }
+        else
+        {
+            *link = tcb_storage_get_tcb_ref(task_id)->next_task_id; 
+            task_delete(task_id); 
+        }
+    }
+}
+
+int task_get_stack_used(int task_id)
+{
+    /* a pointer to the TCB for task_id */ 
+    task_control_block *tcb_ref = tcb_storage_get_tcb_ref(task_id); 
+    /* the lowest stack item which has been used */ 
+    int i = 1; 
+
+    if (tcb_ref->stack_limit == 0)
+    {
+        return -1; 
+    }
+    if (tcb_ref->stack_limit[0] != STACK_CANARY)
+    {
+        return tcb_ref->stack_size; 
+    }
+    while (i < tcb_ref->stack_size && 
+           tcb_ref->stack_limit[i] == STACK_FILL_PATTERN)
+    {
+        i++; 
+    }
+    return tcb_ref->stack_size - i; 
+}
+
+/* check_stack: checks the canary at the stack limit of 
+   task_id, if the stack size is known, and stops the 
+   kernel if the stack has overflowed. Shall be called 
+   by task_id, so that the stack pointer also can be 
+   checked. */ 
+static void check_stack(int task_id)
+{
+    /* a pointer to the TCB for task_id, which is stored on 
+       the stack, and thus also gives the stack position */ 
+    task_control_block *tcb_ref = tcb_storage_get_tcb_ref(task_id); 
+
+    if (tcb_ref->stack_limit == 0 || 
+        (tcb_ref->stack_limit[0] == STACK_CANARY && 
+         (stack_item *) &tcb_ref > tcb_ref->stack_limit))
+    {
+        return; 
+    }
+    console_put_string("Simple_OS: stack overflow in task "); 
+    console_put_hex(task_id); 
+    console_put_string("\n"); 
+    /* stop, with interrupts disabled, before the overflow 
+       corrupts other data */ 
+#if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
+    exit(1); 
+#else
+    while (1)
+    {
+    }
+#endif
+}
+
 int task_get_task_id_running()
 {
-    return Task_Id_Running; 
+    return Task_Id_Running[smp_get_cpu_id()]; 
+}
+
+int task_get_task_id_running_on(int cpu)
+{
+    return Task_Id_Running[cpu]; 
+}
+
+long long task_get_run_time_ns(int task_id, long long now_ns)
+{
+    /* a pointer to the TCB for task_id */ 
+    task_control_block *tcb_ref = tcb_storage_get_tcb_ref(task_id); 
+    /* the CPU where the task may run */ 
+    int cpu = tcb_ref->cpu; 
+
+    /* add the time since the task started running, if running */ 
+    if (Task_Id_Running[cpu] == task_id)
+    {
+        return tcb_ref->run_time_ns + now_ns - tcb_ref->switch_in_ns; 
+    }
+    return tcb_ref->run_time_ns; 
+}
+
+long task_get_n_switches(void)
+{
+    return Task_N_Switches; 
 }
 
 /* fig_begin task_start */ 
@@ -158,7 +489,10 @@ void task_start(int task_id)
     tcb_ref = tcb_storage_get_tcb_ref(task_id); 
 
     /* set Task_Id_Running to task id of new task */ 
-    Task_Id_Running = task_id; 
+    Task_Id_Running[smp_get_cpu_id()] = task_id; 
+
+    /* the task starts running now */ 
+    account_switch(TASK_ID_INVALID, task_id, task_get_time_ns()); 
 
     /* restore context for the task with this 
        TCB */ 
@@ -188,9 +522,18 @@ void task_switch(int task_id_old, int task_id_new)
     new_stack_pointer = new_tcb_ref->stack_pointer; 
 
     /* set Task_Id_Running to task id of new task */ 
-    Task_Id_Running = task_id_new; 
+    Task_Id_Running[smp_get_cpu_id()] = task_id_new; 
 /* fig_end task_switch_soft_kernel */ 
 
+    /* check that the old task has not overflowed its stack */ 
+    check_stack(task_id_old); 
+
+    /* account the run time of the old task */ 
+    account_switch(task_id_old, task_id_new, task_get_time_ns()); 
+
+    /* load the FPU state of the new task, if needed */ 
+    fpu_switch(task_id_old, task_id_new); 
+
 #ifdef BUILD_ARM_BB
     if (int_status_is_interrupt_active())
     {
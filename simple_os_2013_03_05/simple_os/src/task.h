@@ -34,10 +34,67 @@ int task_create(
     void (*task_function)(void), 
     stack_item *stack_bottom, int priority); 
 
+/* task_set_return_function: sets the function to which a 
+   task function returns, on host builds */ 
+void task_set_return_function(void (*return_function)(void)); 
+
+/* task_create_stack: creates a task as task_create, with the 
+   stack stack, of size stack_size stack items. The stack is 
+   filled with a pattern, and a canary is stored at its limit, 
+   which is checked each time the task stops running. 
+   The task_id of the created task is returned. */ 
+int task_create_stack(
+    void (*task_function)(void), 
+    stack_item stack[], int stack_size, int priority); 
+
+/* task_create_auto: creates a task as task_create_stack, with 
+   a stack of at least stack_size stack items, allocated from 
+   the stack arena, see stack_arena.h. The stack is freed when 
+   the task is deleted. The task_id of the created task is 
+   returned, or TASK_ID_INVALID if no TCB or stack is available. */ 
+int task_create_auto(
+    void (*task_function)(void), int stack_size, int priority); 
+
+/* task_is_running: returns 1 if task_id is running on 
+   some CPU, otherwise 0 */ 
+int task_is_running(int task_id); 
+
+/* task_delete: frees the TCB of task_id, and its stack, if 
+   allocated by task_create_auto. The task shall not be stored 
+   in any list. If task_id is running, it is freed by task_reap, 
+   when it has stopped running. */ 
+void task_delete(int task_id); 
+
+/* task_reap: frees the TCBs and stacks of deleted tasks 
+   which have stopped running */ 
+void task_reap(void); 
+
+/* task_get_stack_used: returns the largest number of stack 
+   items used by task_id, or -1 if the stack size is not 
+   known. The stack size is returned if the stack has 
+   overflowed. */ 
+int task_get_stack_used(int task_id); 
+
 /* task_get_task_id_running: returns the task id of the 
    running task */ 
 int task_get_task_id_running(); 
 
+/* task_get_task_id_running_on: returns the task id of the 
+   task running on cpu, see smp.h */ 
+int task_get_task_id_running_on(int cpu); 
+
+/* task_get_time_ns: returns the time used for CPU accounting, 
+   in nanoseconds, or 0 if there is no clock */ 
+long long task_get_time_ns(void); 
+
+/* task_get_run_time_ns: returns the total time during which 
+   task_id has run, including the current run, at the time 
+   now_ns, if the task is running */ 
+long long task_get_run_time_ns(int task_id, long long now_ns); 
+
+/* task_get_n_switches: returns the total number of task switches */ 
+long task_get_n_switches(void); 
+
 /* task_start: starts task task_id */ 
 void task_start(int task_id); 
 
@@ -20,43 +20,34 @@
 
 #include "task_message.h"
 
-#include "task_id_list.h"
-
-void message_init(task_message_type *message)
+void message_write(
+    task_message_type *message, 
+    const char message_data[], int length, int send_task_id)
 {
     int i; 
+    /* the contents, stored after the message */ 
+    char *data = TASK_MESSAGE_DATA(message); 
 
-    for (i = 0; i < MAX_MESSAGE_LENGTH; i++)
+    for (i = 0; i < length; i++)
     {
-	message->message_data[i] = '\0'; 
+	data[i] = message_data[i]; 
     }
-    message->length = 0; 
-    message->send_task_id = TASK_ID_INVALID; 
+    message->next = 0; 
+    message->block = 0; 
+    message->length = length; 
+    message->send_task_id = send_task_id; 
+    message->priority = MESSAGE_N_PRIORITIES - 1; 
 }
 
-void message_write(
+void message_write_block(
     task_message_type *message, 
-    const char message_data[], int length, int send_task_id)
+    void *block, int length, int send_task_id)
 {
-    int i; 
-    int n_chars_to_write; 
-    
-    if (length > MAX_MESSAGE_LENGTH)
-    {
-	n_chars_to_write = MAX_MESSAGE_LENGTH; 
-    }
-    else
-    {
-	n_chars_to_write = length; 
-    }
- 
-
-    for (i = 0; i < n_chars_to_write; i++)
-    {
-	message->message_data[i] = message_data[i]; 
-    }
-    message->length = n_chars_to_write; 
+    message->next = 0; 
+    message->block = block; 
+    message->length = length; 
     message->send_task_id = send_task_id; 
+    message->priority = MESSAGE_N_PRIORITIES - 1; 
 }
 
 void message_read(
@@ -64,12 +55,13 @@ void message_read(
      char message_data[], int *length, int *send_task_id)
 {
     int i; 
+    /* the contents, stored after the message */ 
+    char *data = TASK_MESSAGE_DATA(message); 
 
     for (i = 0; i < message->length; i++)
     {
-	message_data[i] = message->message_data[i]; 
+	message_data[i] = data[i]; 
     }
     *length = message->length; 
     *send_task_id = message->send_task_id; 
 }
-
@@ -23,26 +23,53 @@
 
 #define MAX_MESSAGE_LENGTH 100
 
-/* data type for buffered messages */ 
-typedef struct
+/* number of message priorities, which may be set at 
+   compile time, but not larger than BITMAP_WORD_SIZE */ 
+#ifndef MESSAGE_N_PRIORITIES
+#define MESSAGE_N_PRIORITIES 4
+#endif
+
+/* data type for buffered messages, which are allocated from 
+   a pool. The contents of a copied message is stored after 
+   the message, see TASK_MESSAGE_DATA. */ 
+typedef struct task_message_struct
 {
-    /* message contents */ 
-    char message_data[MAX_MESSAGE_LENGTH]; 
+    /* the next buffered message, in the same mailbox */ 
+    struct task_message_struct *next; 
+    /* a block with the message contents, which is passed 
+       without copying, or 0 if the contents is copied */ 
+    void *block; 
     /* length of stored message */ 
     int length; 
     /* task_id for sending task */ 
     int send_task_id; 
+    /* priority, where 0 is the most urgent */ 
+    int priority; 
 } task_message_type; 
 
-void message_init(task_message_type *message); 
+/* TASK_MESSAGE_DATA: the contents of a copied message */ 
+#define TASK_MESSAGE_DATA(message) ((char *) ((message) + 1))
+
+/* TASK_MESSAGE_SIZE: the size, in bytes, of a message 
+   with length bytes of copied contents */ 
+#define TASK_MESSAGE_SIZE(length) (sizeof(task_message_type) + (length))
 
+/* message_write: stores message_data, with length 
+   characters, after message, where length shall be at 
+   most MAX_MESSAGE_LENGTH */ 
 void message_write(
     task_message_type *message, 
     const char message_data[], int length, int send_task_id); 
 
+/* message_write_block: stores block, with length bytes, 
+   in message, without copying the contents */ 
+void message_write_block(
+    task_message_type *message, 
+    void *block, int length, int send_task_id); 
+
+/* message_read: copies the contents of a copied message */ 
 void message_read(
      task_message_type *message, 
      char message_data[], int *length, int *send_task_id); 
 
 #endif
-
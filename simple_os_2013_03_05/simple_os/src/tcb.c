@@ -21,15 +21,68 @@
 #include "tcb.h"
 
 #include "console.h"
+#include "task_id_list.h"
 
 void tcb_reset(task_control_block *tcb)
 {
+    /* loop counter */ 
+    int i; 
+
     /* set all fields to zero */ 
     tcb->stack_pointer = 0; 
     tcb->task_id = 0; 
     tcb->valid = 0;
     tcb->wait_ticks = 0; 
+    tcb->wakeup_tick = 0; 
+    tcb->is_timed = 0; 
+    tcb->timed_out = 0; 
+    tcb->time_next_task_id = TASK_ID_INVALID; 
+    tcb->time_prev_task_id = TASK_ID_INVALID; 
     tcb->priority = 0; 
+    tcb->base_priority = 0; 
+    tcb->waiting_mutex = 0; 
+    tcb->held_mutexes = 0; 
+    tcb->held_ceiling_sems = 0; 
+    tcb->wait_list = 0; 
+    tcb->is_ready = 0; 
+    tcb->next_task_id = TASK_ID_INVALID; 
+    tcb->prev_task_id = TASK_ID_INVALID; 
+    tcb->heap_index = -1; 
+    tcb->is_periodic = 0; 
+    tcb->period_us = 0; 
+    tcb->deadline_us = 0; 
+    tcb->release_us = 0; 
+    tcb->n_releases = 0; 
+    tcb->n_overruns = 0; 
+    tcb->n_deadline_misses = 0; 
+    tcb->min_jitter_us = 0; 
+    tcb->max_jitter_us = 0; 
+    tcb->sum_jitter_us = 0; 
+    tcb->fpu_context = -1; 
+    tcb->cpu = 0; 
+    tcb->switch_in_ns = 0; 
+    tcb->run_time_ns = 0; 
+    tcb->n_switches = 0; 
+    tcb->n_voluntary = 0; 
+    tcb->n_preempted = 0; 
+    tcb->stack_limit = 0; 
+    tcb->stack_size = 0; 
+    tcb->pool_block = 0; 
+    tcb->message_call = 0; 
+    tcb->wait_any_nodes = 0; 
+    tcb->n_wait_any_nodes = 0; 
+    tcb->arena_stack = 0; 
+    tcb->arena_stack_size = 0; 
+    tcb->has_exited = 0; 
+    tcb->latency_pending = 0; 
+    tcb->ready_ns = 0; 
+    tcb->n_latencies = 0; 
+    tcb->sum_latency_ns = 0; 
+    tcb->max_latency_ns = 0; 
+    for (i = 0; i < LATENCY_N_BUCKETS; i++)
+    {
+        tcb->latency_histogram[i] = 0; 
+    }
 }
 
 void tcb_init(
@@ -37,7 +90,18 @@ void tcb_init(
 {
     tcb_reset(tcb); 
     tcb->stack_pointer = stack_pointer; 
+    /* keep the priority within the range handled 
+       by the ready list */ 
+    if (priority < 0)
+    {
+        priority = 0; 
+    }
+    if (priority > N_PRIORITY_LEVELS - 1)
+    {
+        priority = N_PRIORITY_LEVELS - 1; 
+    }
     tcb->priority = priority; 
+    tcb->base_priority = priority; 
 }
 
 int tcb_is_valid(task_control_block *tcb)
@@ -23,6 +23,29 @@
 
 #include "arch_types.h"
 
+/* number of priority levels. Priority values are in the 
+   range 0 .. N_PRIORITY_LEVELS-1, where 0 is the highest 
+   priority */ 
+#define N_PRIORITY_LEVELS 1024
+
+/* number of buckets in the wakeup latency histogram. Bucket 0 
+   counts latencies below 1 microsecond, bucket i, for 0 < i < 
+   LATENCY_N_BUCKETS-1, counts latencies from 2^(i-1) up to 
+   2^i microseconds, and the last bucket counts the rest */ 
+#define LATENCY_N_BUCKETS 24
+
+/* the mutex type, defined in si_mutex.h */ 
+struct si_mutex_struct; 
+
+/* the semaphore type, defined in si_semaphore.h */ 
+struct si_semaphore_struct; 
+
+/* the wait list type, defined in wait_list.h */ 
+struct wait_list_struct; 
+
+/* the node type for si_wait_any, defined in wait_any.h */ 
+struct wait_any_node_struct; 
+
 /* fig_begin tcb_def */ 
 /* type definition for a task control block */
 typedef struct
@@ -35,8 +58,103 @@ typedef struct
     int valid;
     /* waiting time in ticks */ 
     int wait_ticks; 
-    /* priority */ 
+    /* tick number when the waiting time expires */ 
+    unsigned int wakeup_tick; 
+    /* flag to indicate if the task is in the time list */ 
+    int is_timed; 
+    /* flag to indicate that the waiting time expired, 
+       when the task also waited for another event */ 
+    int timed_out; 
+    /* task ids of the next and previous task in the 
+       time list */ 
+    int time_next_task_id; 
+    int time_prev_task_id; 
+    /* priority, which is raised above base_priority 
+       when the task holds a mutex needed by a task 
+       with higher priority */ 
     int priority; 
+    /* the priority assigned when the task was created */ 
+    int base_priority; 
+    /* the mutex which the task waits for, if any */ 
+    struct si_mutex_struct *waiting_mutex; 
+    /* the first of the mutexes held by the task */ 
+    struct si_mutex_struct *held_mutexes; 
+    /* the first of the semaphores with ceiling held by the task */ 
+    struct si_semaphore_struct *held_ceiling_sems; 
+    /* the wait list where the task is stored, if any */ 
+    struct wait_list_struct *wait_list; 
+    /* flag to indicate if the task is in the ready list */ 
+    int is_ready; 
+    /* task ids of the next and previous task in the 
+       list where the task is stored */ 
+    int next_task_id; 
+    int prev_task_id; 
+    /* position in the deadline ordered part of the ready 
+       list, or -1 if the task is not stored there */ 
+    int heap_index; 
+    /* flag to indicate if the task is periodic */ 
+    int is_periodic; 
+    /* period and relative deadline, in microseconds */ 
+    long period_us; 
+    long deadline_us; 
+    /* the absolute time of the latest release */ 
+    long long release_us; 
+    /* release statistics for a periodic task */ 
+    int n_releases; 
+    int n_overruns; 
+    int n_deadline_misses; 
+    long min_jitter_us; 
+    long max_jitter_us; 
+    long long sum_jitter_us; 
+    /* index of the private FPU context, or -1 if 
+       the task does not use floating point */ 
+    int fpu_context; 
+    /* the CPU whose ready list stores the task, see smp.h */ 
+    int cpu; 
+    /* CPU accounting: the time when the task last started 
+       running, and the total run time, in nanoseconds */ 
+    long long switch_in_ns; 
+    long long run_time_ns; 
+    /* number of times the task has started running, and 
+       number of times it stopped running because it waited 
+       (voluntary) or because another task was selected 
+       while it was still ready (preempted) */ 
+    int n_switches; 
+    int n_voluntary; 
+    int n_preempted; 
+    /* the lowest address of the stack, where a canary is 
+       stored, and the stack size, in stack items. The 
+       stack_limit is 0 when the stack size is not known. */ 
+    stack_item *stack_limit; 
+    int stack_size; 
+    /* a block given by si_pool_free to the task, 
+       while it waits in si_pool_alloc */ 
+    void *pool_block; 
+    /* the call of the task, see si_message_send_receive, while 
+       it waits for a reply, or for a call to receive */ 
+    void *message_call; 
+    /* the nodes by which the task waits in si_wait_any, 
+       and their number, or 0 */ 
+    struct wait_any_node_struct *wait_any_nodes; 
+    int n_wait_any_nodes; 
+    /* the stack allocated by task_create_auto, and its size 
+       in stack items, or 0 if the stack was given by the 
+       creator of the task */ 
+    stack_item *arena_stack; 
+    int arena_stack_size; 
+    /* flag to indicate that the task has exited, and 
+       waits for its TCB and stack to be freed */ 
+    int has_exited; 
+    /* flag to indicate that the task has become ready, and 
+       has not yet run, and the time when it became ready */ 
+    int latency_pending; 
+    long long ready_ns; 
+    /* wakeup latency statistics: the time from when the task 
+       becomes ready until it runs */ 
+    int n_latencies; 
+    long long sum_latency_ns; 
+    long long max_latency_ns; 
+    unsigned int latency_histogram[LATENCY_N_BUCKETS]; 
 } task_control_block;
 /* fig_end tcb_def */ 
 
@@ -44,7 +162,8 @@ typedef struct
 void tcb_reset(task_control_block *tcb); 
 
 /* tcb_init: initialises *tcb, setting the fields 
-   stack_pointer and priority */ 
+   stack_pointer and priority. The priority is limited 
+   to the range 0 .. N_PRIORITY_LEVELS-1 */ 
 void tcb_init(
     task_control_block *tcb, 
     mem_address stack_pointer, int priority); 
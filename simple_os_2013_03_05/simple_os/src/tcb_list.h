@@ -23,24 +23,22 @@
 
 #include "tcb.h"
 
-void tcb_list_reset(task_control_block tcb_list[], int length); 
+/* tcb_list_reset: resets all elements of tcb_list, and links 
+   them into a list of free elements, with first element *free_first */ 
+void tcb_list_reset(
+    task_control_block tcb_list[], int length, int *free_first); 
 
+/* tcb_list_insert: stores tcb in a free element of tcb_list, and 
+   returns its task id, or TASK_ID_INVALID if there is no free element */ 
 int tcb_list_insert(
-    task_control_block tcb_list[], int length,
+    task_control_block tcb_list[], int *free_first,
     task_control_block tcb); 
 
-/* tcb_list_get_task_id_highest_prio: get the task id in 
-   task_id_list, corresponding to the task with the 
-   highest priority, as specified by the TCBs stored 
-   in tcb_list */ 
-int tcb_list_get_task_id_highest_prio(
-    task_control_block tcb_list[], int tcb_list_length, 
-    int task_id_list[], int task_id_list_length); 
-
-void tcb_list_decrement_timers(
-    task_control_block tcb_list[], int tcb_list_length, 
-    int task_id_list[], int task_id_list_length, 
-    int *n_timers_set_to_zero, int task_ids_set_to_zero[]); 
+/* tcb_list_remove: resets the element task_id of tcb_list, and 
+   returns it to the list of free elements, which is kept in index 
+   order, so that tcb_list_insert uses the lowest free task id */ 
+void tcb_list_remove(
+    task_control_block tcb_list[], int *free_first, int task_id); 
 
 #endif
 
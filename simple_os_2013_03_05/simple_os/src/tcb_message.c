@@ -23,26 +23,38 @@
 #include "task_message.h"
 #include "task_id_list.h"
 #include "wait_list.h"
+#include "wait_any.h"
 #include "ready_list.h"
 #include "schedule.h"
+#include "time_handler.h"
+#include "bitmap.h"
 
-void tcb_message_init(tcb_message_type *tcb_message)
+#if MESSAGE_N_PRIORITIES > BITMAP_WORD_SIZE
+#error "MESSAGE_N_PRIORITIES shall be at most BITMAP_WORD_SIZE"
+#endif
+
+void tcb_message_init(tcb_message_type *tcb_message, int depth)
 {
     int i; 
 
     tcb_message->receive_task_id = TASK_ID_INVALID; 
-    tcb_message->receive_task_id_is_waiting = 0; 
-
-    wait_list_reset(tcb_message->wait_list_send, WAIT_LIST_SIZE); 
 
-    for (i = 0; i < MESSAGE_LIST_SIZE; i++)
+    wait_list_reset(&tcb_message->wait_list_receive); 
+    for (i = 0; i < MESSAGE_N_PRIORITIES; i++)
     {
-	message_init(&tcb_message->message_buffer[i]); 
+	wait_list_reset(&tcb_message->wait_list_send[i]); 
+	tcb_message->first[i] = 0; 
+	tcb_message->last[i] = 0; 
+	tcb_message->count[i] = 0; 
     }
-
-    tcb_message->read_pos = 0; 
-    tcb_message->write_pos = 0; 
-    tcb_message->count = 0; 
+    tcb_message->n_send_waiting = 0; 
+    tcb_message->priority_bitmap = 0; 
+    tcb_message->depth = depth; 
+
+    wait_list_reset(&tcb_message->wait_list_call); 
+    wait_list_reset(&tcb_message->wait_list_reply); 
+    tcb_message->call_receive_waiting = 0; 
+    wait_any_list_reset(&tcb_message->wait_any_list); 
 }
 
 void tcb_message_set_receive_task_id(tcb_message_type *tcb_message, int receive_task_id)
@@ -50,60 +62,166 @@ void tcb_message_set_receive_task_id(tcb_message_type *tcb_message, int receive_
     tcb_message->receive_task_id = receive_task_id; 
 }
 
-void tcb_message_write(
+int tcb_message_write(
     tcb_message_type *tcb_message, 
-    const char message_data[], int length, int send_task_id)
+    task_message_type *message, int send_task_id, int n_ticks)
 {
-    while(tcb_message->count == MESSAGE_LIST_SIZE)
+    /* the priority of the message */ 
+    int priority = message->priority; 
+    /* the tick at which the timeout expires */ 
+    unsigned int expiry_tick = 0; 
+
+    if (n_ticks > 0)
     {
+	expiry_tick = time_handler_get_expiry_tick(n_ticks); 
+    }
+    while(tcb_message->count[priority] >= tcb_message->depth)
+    {
+	if (n_ticks == 0)
+	{
+	    return -1; 
+	}
 	ready_list_remove(send_task_id); 
-	wait_list_insert(tcb_message->wait_list_send, WAIT_LIST_SIZE, send_task_id); 
+	wait_list_insert(&tcb_message->wait_list_send[priority], send_task_id); 
+	if (n_ticks != TIME_HANDLER_WAIT_FOREVER)
+	{
+	    time_handler_start_timeout(n_ticks); 
+	}
+	tcb_message->n_send_waiting++; 
 	schedule(); 
+	tcb_message->n_send_waiting--; 
+	if (tcb_message->receive_task_id == TASK_ID_INVALID)
+	{
+	    return -1; 
+	}
+	if (n_ticks != TIME_HANDLER_WAIT_FOREVER)
+	{
+	    if (time_handler_has_timed_out())
+	    {
+		return -1; 
+	    }
+	    /* the mailbox may have been filled again by another 
+	       sender, and the task then waits for the remaining 
+	       part of the timeout */ 
+	    n_ticks = time_handler_get_ticks_left(expiry_tick); 
+	}
+    }
+    message->next = 0; 
+    if (tcb_message->last[priority] == 0)
+    {
+	tcb_message->first[priority] = message; 
+    }
+    else
+    {
+	tcb_message->last[priority]->next = message; 
     }
-    message_write(
-        &tcb_message->message_buffer[tcb_message->write_pos], 
-	message_data, length, send_task_id); 
-    tcb_message->write_pos++; 
-    if (tcb_message->write_pos == MESSAGE_LIST_SIZE)
+    tcb_message->last[priority] = message; 
+    tcb_message->count[priority]++; 
+    tcb_message->priority_bitmap |= 1u << priority; 
+    if (!wait_list_is_empty(&tcb_message->wait_list_receive))
     {
-	tcb_message->write_pos = 0; 
+	ready_list_insert(
+	    wait_list_remove_one(&tcb_message->wait_list_receive)); 
+	schedule(); 
     }
-    tcb_message->count++; 
-    if (tcb_message->receive_task_id_is_waiting)
+    else if (wait_any_list_notify(&tcb_message->wait_any_list) > 0)
     {
-	ready_list_insert(tcb_message->receive_task_id); 
-	tcb_message->receive_task_id_is_waiting = 0; 
 	schedule(); 
     }
+    return 0; 
 }
 
-void tcb_message_read(
-    tcb_message_type *tcb_message, 
-    char message_data[], int *length, int *send_task_id)
+task_message_type *tcb_message_remove(tcb_message_type *tcb_message)
+{
+    int priority; 
+    task_message_type *message; 
+
+    if (tcb_message->priority_bitmap == 0)
+    {
+	return 0; 
+    }
+    priority = bitmap_find_first_set(tcb_message->priority_bitmap); 
+    message = tcb_message->first[priority]; 
+    tcb_message->first[priority] = message->next; 
+    if (tcb_message->first[priority] == 0)
+    {
+	tcb_message->last[priority] = 0; 
+	tcb_message->priority_bitmap &= ~(1u << priority); 
+    }
+    tcb_message->count[priority]--; 
+    return message; 
+}
+
+task_message_type *tcb_message_read(
+    tcb_message_type *tcb_message, int n_ticks)
 {
     int task_id_waiting; 
+    task_message_type *message; 
+    /* the wait list for tasks sending with the priority of message */ 
+    wait_list_type *wait_list_send; 
+    /* the tick at which the timeout expires */ 
+    unsigned int expiry_tick = 0; 
 
-    while(tcb_message->count == 0)
+    if (n_ticks > 0)
     {
-	ready_list_remove(tcb_message->receive_task_id); 
-	tcb_message->receive_task_id_is_waiting = 1; 
-	schedule(); 
+	expiry_tick = time_handler_get_expiry_tick(n_ticks); 
     }
-    message_read(
-        &tcb_message->message_buffer[tcb_message->read_pos], 
-	message_data, length, send_task_id); 
-    tcb_message->read_pos++; 
-    if (tcb_message->read_pos == MESSAGE_LIST_SIZE)
+    while(tcb_message->priority_bitmap == 0)
     {
-	tcb_message->read_pos = 0; 
+	if (n_ticks == 0)
+	{
+	    return 0; 
+	}
+	ready_list_remove(tcb_message->receive_task_id); 
+	wait_list_insert(
+	    &tcb_message->wait_list_receive, tcb_message->receive_task_id); 
+	if (n_ticks != TIME_HANDLER_WAIT_FOREVER)
+	{
+	    time_handler_start_timeout(n_ticks); 
+	}
+	schedule(); 
+	if (n_ticks != TIME_HANDLER_WAIT_FOREVER)
+	{
+	    if (time_handler_has_timed_out())
+	    {
+		return 0; 
+	    }
+	    n_ticks = time_handler_get_ticks_left(expiry_tick); 
+	}
     }
-    tcb_message->count--; 
-    if (!wait_list_is_empty(tcb_message->wait_list_send, WAIT_LIST_SIZE))
+    message = tcb_message_remove(tcb_message); 
+    wait_list_send = &tcb_message->wait_list_send[message->priority]; 
+    if (!wait_list_is_empty(wait_list_send))
     {
-	task_id_waiting = wait_list_remove_highest_prio(
-	    tcb_message->wait_list_send, WAIT_LIST_SIZE); 
+	task_id_waiting = wait_list_remove_highest_prio(wait_list_send); 
 	ready_list_insert(task_id_waiting); 
 	schedule(); 
     }
+    return message; 
 }
 
+void tcb_message_close(tcb_message_type *tcb_message)
+{
+    int i; 
+
+    tcb_message->receive_task_id = TASK_ID_INVALID; 
+    for (i = 0; i < MESSAGE_N_PRIORITIES; i++)
+    {
+	while (!wait_list_is_empty(&tcb_message->wait_list_send[i]))
+	{
+	    ready_list_insert(
+		wait_list_remove_highest_prio(&tcb_message->wait_list_send[i])); 
+	}
+    }
+    while (!wait_list_is_empty(&tcb_message->wait_list_call))
+    {
+	ready_list_insert(
+	    wait_list_remove_highest_prio(&tcb_message->wait_list_call)); 
+    }
+    while (!wait_list_is_empty(&tcb_message->wait_list_reply))
+    {
+	ready_list_insert(
+	    wait_list_remove_highest_prio(&tcb_message->wait_list_reply)); 
+    }
+    tcb_message->call_receive_waiting = 0; 
+}
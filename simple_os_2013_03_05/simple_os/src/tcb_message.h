@@ -22,47 +22,85 @@
 #define TCB_MESSAGE_H
 
 #include "task_message.h"
-#include "tcb_storage.h"
+#include "wait_list.h"
+#include "wait_any.h"
 
-#define WAIT_LIST_SIZE TCB_LIST_SIZE
-
-#define MESSAGE_LIST_SIZE 2
-
-/* data type for messages, associated to each TCB */ 
+/* data type for the mailbox of a task, where messages are 
+   buffered in a list for each priority, in the order they 
+   are sent */ 
 typedef struct
 {
     /* task_id for receiving task */ 
     int receive_task_id; 
-    /* flag to indicate if the receiving task 
-       is waiting */ 
-    int receive_task_id_is_waiting; 
-
-    /* wait list for sending tasks */
-    int wait_list_send[WAIT_LIST_SIZE]; 
-
-    /* buffered messages */ 
-    task_message_type message_buffer[MESSAGE_LIST_SIZE]; 
-
-    /* positions for reading and writing buffered 
-       messages */ 
-    int read_pos; 
-    int write_pos; 
-
-    /* number of buffered messages */ 
-    int count; 
+    /* wait list for the receiving task, when it waits */ 
+    wait_list_type wait_list_receive; 
+
+    /* wait lists for sending tasks, for each priority, 
+       and the number of sending tasks which wait */
+    wait_list_type wait_list_send[MESSAGE_N_PRIORITIES]; 
+    int n_send_waiting; 
+
+    /* buffered messages, for each priority, oldest first */ 
+    task_message_type *first[MESSAGE_N_PRIORITIES]; 
+    task_message_type *last[MESSAGE_N_PRIORITIES]; 
+
+    /* bitmap where bit i is set if there are buffered 
+       messages with priority i */ 
+    unsigned int priority_bitmap; 
+
+    /* number of buffered messages, for each priority, 
+       and the largest number of buffered messages for 
+       a priority */ 
+    int count[MESSAGE_N_PRIORITIES]; 
+    int depth; 
+
+    /* wait lists for calling tasks, see si_message_send_receive, 
+       which wait until their calls are received, and replied */ 
+    wait_list_type wait_list_call; 
+    wait_list_type wait_list_reply; 
+    /* flag to indicate that the receiving task waits for a call */ 
+    int call_receive_waiting; 
+
+    /* the list where the receiving task waits in si_wait_any */ 
+    wait_any_list_type wait_any_list; 
 } tcb_message_type; 
 
-void tcb_message_init(tcb_message_type *tcb_message); 
+/* tcb_message_init: initialises tcb_message, with 
+   room for depth buffered messages */ 
+void tcb_message_init(tcb_message_type *tcb_message, int depth); 
 
 void tcb_message_set_receive_task_id(tcb_message_type *tcb_message, int receive_task_id); 
 
-void tcb_message_write(
-    tcb_message_type *tcb_message, 
-    const char message_data[], int length, int send_task_id); 
-
-void tcb_message_read(
+/* tcb_message_write: adds message, waiting as send_task_id 
+   while the mailbox is full, i.e. there are depth buffered 
+   messages with the same priority as message, and wakes the 
+   receiving task, also when it waits in si_wait_any. 
+   The sending task waits at most n_ticks ticks, where 0 means 
+   that it does not wait, and TIME_HANDLER_WAIT_FOREVER that 
+   there is no timeout. Returns 0, or -1 if the message was 
+   not added, since the mailbox was full when the waiting time 
+   expired, or the mailbox was closed, by tcb_message_close. */ 
+int tcb_message_write(
     tcb_message_type *tcb_message, 
-    char message_data[], int *length, int *send_task_id); 
+    task_message_type *message, int send_task_id, int n_ticks); 
+
+/* tcb_message_read: removes and returns the oldest message 
+   with the most urgent priority, 
+   waiting as the receiving task while the mailbox is empty, 
+   at most n_ticks ticks, as for tcb_message_write, and wakes 
+   a sending task. Returns 0 if there is no message when the 
+   waiting time expires. */ 
+task_message_type *tcb_message_read(
+    tcb_message_type *tcb_message, int n_ticks); 
+
+/* tcb_message_remove: removes and returns the message which 
+   tcb_message_read would return, or 0, without waiting */ 
+task_message_type *tcb_message_remove(tcb_message_type *tcb_message); 
+
+/* tcb_message_close: closes tcb_message, when the receiving 
+   task is deleted, and wakes the sending and calling tasks 
+   which wait. 
+   The mailbox shall not be freed until n_send_waiting is 0. */ 
+void tcb_message_close(tcb_message_type *tcb_message); 
 
 #endif
-
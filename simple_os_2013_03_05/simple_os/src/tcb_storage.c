@@ -28,14 +28,23 @@
 static task_control_block TCB_List[TCB_LIST_SIZE]; 
 /* fig_end tcb_list */ 
 
+/* the first TCB in the list of free TCBs, which is linked 
+   using the next_task_id field */ 
+static int Free_First; 
+
 void tcb_storage_init(void)
 {
-    tcb_list_reset(TCB_List, TCB_LIST_SIZE); 
+    tcb_list_reset(TCB_List, TCB_LIST_SIZE, &Free_First); 
 }
 
 int tcb_storage_install_tcb(task_control_block tcb)
 {
-    return tcb_list_insert(TCB_List, TCB_LIST_SIZE, tcb); 
+    return tcb_list_insert(TCB_List, &Free_First, tcb); 
+}
+
+void tcb_storage_free_tcb(int task_id)
+{
+    tcb_list_remove(TCB_List, &Free_First, task_id); 
 }
 
 task_control_block *tcb_storage_get_tcb_ref(int task_id) 
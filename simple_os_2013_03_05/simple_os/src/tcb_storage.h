@@ -23,15 +23,23 @@
 
 #include "tcb.h"
 
-/* maximum number of tasks */ 
+/* maximum number of tasks, which may be set 
+   at compile time, e.g. by -DTCB_LIST_SIZE=100 */ 
+#ifndef TCB_LIST_SIZE
 #define TCB_LIST_SIZE 20
+#endif
 
 /* tcb_storage_init: perform initialisation */ 
 void tcb_storage_init(void); 
 
-/* tcb_storage_install_tcb: installs tcb */ 
+/* tcb_storage_install_tcb: installs tcb, and returns its 
+   task id, or TASK_ID_INVALID if all TCBs are used */ 
 int tcb_storage_install_tcb(task_control_block tcb); 
 
+/* tcb_storage_free_tcb: frees the TCB with task id task_id, 
+   so that it can be installed again */ 
+void tcb_storage_free_tcb(int task_id); 
+
 /* pcb_storage_get_tcb_ref: get reference to TCB with
    task id task_id */ 
 task_control_block *tcb_storage_get_tcb_ref(int task_id); 
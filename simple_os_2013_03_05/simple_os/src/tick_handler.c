@@ -29,8 +29,14 @@
 #include "time_list.h"
 #include "ready_list.h"
 #include "schedule.h"
+#include "task_id_list.h"
+#include "task.h"
+#include "tcb.h"
+#include "wait_list.h"
 
 #include "time_storage.h"
+#include "idle.h"
+#include "smp.h"
 
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
 
@@ -71,6 +77,171 @@ static int interrupt_counter;
 static int interrupt_counter_max; 
 static char interrupt_char; 
 
+/* the number of handled timer interrupts */ 
+static unsigned long N_Interrupts; 
+
+/* the number of registered ticks */ 
+static unsigned int Tick_Count; 
+
+/* time quantum, in ticks, for each priority level, where 
+   0 means that tasks at the level are not time sliced */ 
+static int Time_Slice_Ticks[N_PRIORITY_LEVELS]; 
+
+/* the smallest non-zero time quantum, or 0 if 
+   no level is time sliced */ 
+static int Min_Time_Slice_Ticks; 
+
+/* the task whose time slice is counted, and 
+   the tick when its time slice ends */ 
+static int Slice_Task_Id; 
+static unsigned int Slice_End_Tick; 
+
+/* function called at each timer interrupt, or 0, 
+   see tick_handler_set_poll_function */ 
+static int (*Poll_Function)(void); 
+
+/* register_ticks: registers n_ticks ticks */ 
+static void register_ticks(int n_ticks)
+{
+    Tick_Count += n_ticks; 
+    time_storage_register_ticks(n_ticks); 
+    time_list_register_ticks(n_ticks); 
+}
+
+/* check_time_slice: counts the time slice for the running 
+   task, and moves it last among the ready tasks with the 
+   same priority when its time quantum has expired. Returns 
+   nonzero if the task was moved. */ 
+static int check_time_slice(void)
+{
+    /* the running task, and its TCB */ 
+    int task_id = task_get_task_id_running(); 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    /* the time quantum for the running task */ 
+    int n_slice_ticks = Time_Slice_Ticks[tcb->priority]; 
+
+#ifdef EDF_SCHEDULING
+    /* tasks with deadlines are not time sliced */ 
+    if (tcb->is_periodic)
+    {
+        n_slice_ticks = 0; 
+    }
+#endif
+
+    if (n_slice_ticks == 0)
+    {
+        Slice_Task_Id = TASK_ID_INVALID; 
+        return 0; 
+    }
+    if (task_id != Slice_Task_Id)
+    {
+        /* a new time slice starts */ 
+        Slice_Task_Id = task_id; 
+        Slice_End_Tick = Tick_Count + n_slice_ticks; 
+        return 0; 
+    }
+    if ((int) (Tick_Count - Slice_End_Tick) < 0)
+    {
+        return 0; 
+    }
+    /* the quantum has expired, let the next 
+       task with the same priority run */ 
+    ready_list_remove(task_id); 
+    ready_list_insert(task_id); 
+    /* the time slice for the next task starts now */ 
+    Slice_Task_Id = ready_list_get_task_id_highest_prio(); 
+    Slice_End_Tick = Tick_Count + n_slice_ticks; 
+    return 1; 
+}
+
+#ifdef TIMER_ONE_SHOT
+
+/* the longest time, in microseconds, for which the 
+   timer is armed in tickless mode */ 
+#define TICKLESS_MAX_US 60000000LL
+
+/* the timer interrupts only when a waiting time expires */ 
+static int Tickless; 
+
+/* the number of ticks, counted from time zero of 
+   timer_get_time_us, which have been registered 
+   in tickless mode */ 
+static long long Registered_Ticks; 
+
+/* register_elapsed_ticks: registers the ticks which have 
+   elapsed since ticks were last registered, in tickless mode */ 
+static void register_elapsed_ticks(void)
+{
+    /* number of elapsed ticks */ 
+    int n_ticks; 
+
+    n_ticks = (int) (timer_get_time_us() / timer_get_us_per_tick() - 
+                     Registered_Ticks); 
+    if (n_ticks > 0)
+    {
+        Registered_Ticks += n_ticks; 
+        register_ticks(n_ticks); 
+    }
+}
+
+/* arm_timer: arms the timer for the first expiry of a 
+   waiting time in the time list, in tickless mode */ 
+static void arm_timer(void)
+{
+    /* number of microseconds in one tick */ 
+    long us_per_tick = timer_get_us_per_tick(); 
+    /* number of ticks until the timer shall interrupt */ 
+    int n_ticks; 
+
+    register_elapsed_ticks(); 
+
+    n_ticks = time_list_get_ticks_to_next_expiry(); 
+    if (n_ticks < 0 || n_ticks > TICKLESS_MAX_US / us_per_tick)
+    {
+        n_ticks = (int) (TICKLESS_MAX_US / us_per_tick); 
+    }
+    /* time slices are counted at timer interrupts */ 
+    if (Min_Time_Slice_Ticks > 0 && n_ticks > Min_Time_Slice_Ticks)
+    {
+        n_ticks = Min_Time_Slice_Ticks; 
+    }
+    /* interrupt at a tick boundary. The timer interrupts 
+       at once if the expiry has already passed. */ 
+    timer_set_one_shot((Registered_Ticks + n_ticks) * us_per_tick); 
+}
+
+#endif
+
+/* move_expired_to_ready: moves the tasks whose waiting time 
+   has expired from the time list to the ready list, and 
+   returns the number of moved tasks */ 
+static int move_expired_to_ready(void)
+{
+    /* number of tasks which have become ready */ 
+    int n_new_tasks_ready; 
+    /* task id for a task which has become ready */ 
+    int new_task_id_ready; 
+    /* a pointer to its TCB */ 
+    task_control_block *tcb_ref; 
+
+    n_new_tasks_ready = 0; 
+    new_task_id_ready = time_list_remove_expired(); 
+    while (new_task_id_ready != TASK_ID_INVALID)
+    {
+        /* a task which waits with a timeout stops waiting */ 
+        tcb_ref = tcb_storage_get_tcb_ref(new_task_id_ready); 
+        if (tcb_ref->wait_list != 0)
+        {
+            wait_list_remove(tcb_ref->wait_list, new_task_id_ready); 
+        }
+        tcb_ref->timed_out = 1; 
+        ready_list_insert(new_task_id_ready); 
+        n_new_tasks_ready++; 
+        new_task_id_ready = time_list_remove_expired(); 
+    }
+    return n_new_tasks_ready; 
+}
+
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
 
 #ifdef BUILD_X86_WIN_HOST
@@ -96,12 +267,8 @@ void tick_handler_function(void)
 #endif 
 
 {
-    /* loop counter */ 
-    int i; 
-    /* number of ready tasks */ 
+    /* number of tasks which have become ready */ 
     int n_new_tasks_ready; 
-    /* task ids for ready tasks */ 
-    int new_task_ids_ready[TCB_LIST_SIZE]; 
 
 #ifdef BUILD_X86_WIN_HOST 
 
@@ -114,6 +281,12 @@ void tick_handler_function(void)
 #endif 
 
     // DISABLE_INTERRUPTS; 
+#ifdef SMP_HOST
+    /* the other CPUs may use the kernel data */ 
+    smp_lock(); 
+#endif
+    /* end the sleeping in the idle task, if ongoing */ 
+    idle_register_interrupt(); 
     interrupt_counter++; 
     if (interrupt_counter == interrupt_counter_max)
     {
@@ -125,25 +298,52 @@ void tick_handler_function(void)
     	    interrupt_char = 'a'; 
         }
     }
-    /* register the interrupt */ 
-    time_storage_register_tick(); 
-    /* decrement timers for all waiting processes */ 
-    time_list_decrement_timers(
-        &n_new_tasks_ready, new_task_ids_ready); 
+    N_Interrupts++; 
+#ifdef TIMER_ONE_SHOT
+    if (Tickless)
+    {
+        /* register the ticks since the timer was armed */ 
+        register_elapsed_ticks(); 
+    }
+    else
+#endif
+    {
+        /* the number of ticks, including lost ticks */ 
+        int n_ticks = 1; 
+#ifdef TIMER_ONE_SHOT
+        n_ticks += timer_get_overrun(); 
+#endif
+        /* register the interrupt, also in the time list */ 
+        register_ticks(n_ticks); 
+    }
+    /* count the time slice of the running task */ 
+    n_new_tasks_ready = check_time_slice(); 
+    /* move the tasks whose waiting time has expired 
+       from the time list to the ready list */ 
+    n_new_tasks_ready += move_expired_to_ready(); 
+    /* check for input, which may make tasks ready */ 
+    if (Poll_Function != 0)
+    {
+        n_new_tasks_ready += Poll_Function(); 
+    }
+#ifdef TIMER_ONE_SHOT
+    if (Tickless)
+    {
+        /* arm the timer for the next expiry */ 
+        arm_timer(); 
+    }
+#endif
     /* check if any tasks have become ready */ 
     if (n_new_tasks_ready > 0)
     {
-        for (i = 0; i < n_new_tasks_ready; i++) 
-        {
-            /* move from time list */ 
-            time_list_remove(new_task_ids_ready[i]); 
-            /* and insert in ready list */ 
-            ready_list_insert(new_task_ids_ready[i]); 
-        }
         /* perform scheduling */ 
         schedule(); 
     }
 
+#ifdef SMP_HOST
+    smp_unlock(); 
+#endif
+
 #ifdef BUILD_X86_WIN_HOST 
     
     enable_int_win(); 
@@ -153,9 +353,119 @@ void tick_handler_function(void)
 }
 
 
+int tick_handler_update_time(void)
+{
+#ifdef TIMER_ONE_SHOT
+    if (Tickless)
+    {
+        register_elapsed_ticks(); 
+        return move_expired_to_ready(); 
+    }
+#endif
+    return 0; 
+}
+
+void tick_handler_update_timer(void)
+{
+#ifdef TIMER_ONE_SHOT
+    if (Tickless)
+    {
+        arm_timer(); 
+    }
+#endif
+}
+
+void tick_handler_set_tickless(int tickless)
+{
+#ifdef TIMER_ONE_SHOT
+    if (tickless && !Tickless)
+    {
+        /* the periodic ticks are aligned with the 
+           clock, and the latest has been registered */ 
+        Tickless = 1; 
+        Registered_Ticks = timer_get_time_us() / timer_get_us_per_tick(); 
+        arm_timer(); 
+    }
+    else if (!tickless && Tickless)
+    {
+        register_elapsed_ticks(); 
+        Tickless = 0; 
+        timer_init(); 
+    }
+#endif
+}
+
+int tick_handler_set_tick_rate(int n_ticks_per_sec)
+{
+#ifdef TIMER_ONE_SHOT
+    if (timer_set_tick_rate(n_ticks_per_sec) != 0)
+    {
+        return -1; 
+    }
+    time_storage_set_us_per_tick(timer_get_us_per_tick()); 
+    if (Tickless)
+    {
+        Registered_Ticks = timer_get_time_us() / timer_get_us_per_tick(); 
+        arm_timer(); 
+    }
+    else
+    {
+        timer_init(); 
+    }
+    return 0; 
+#else
+    return -1; 
+#endif
+}
+
+void tick_handler_set_time_slice(int priority, int n_ticks)
+{
+    int i; 
+
+    if (priority < 0 || priority >= N_PRIORITY_LEVELS)
+    {
+        return; 
+    }
+    Time_Slice_Ticks[priority] = n_ticks > 0 ? n_ticks : 0; 
+
+    Min_Time_Slice_Ticks = 0; 
+    for (i = 0; i < N_PRIORITY_LEVELS; i++)
+    {
+        if (Time_Slice_Ticks[i] > 0 && 
+            (Min_Time_Slice_Ticks == 0 || 
+             Time_Slice_Ticks[i] < Min_Time_Slice_Ticks))
+        {
+            Min_Time_Slice_Ticks = Time_Slice_Ticks[i]; 
+        }
+    }
+}
+
+unsigned long tick_handler_get_n_interrupts(void)
+{
+    return N_Interrupts; 
+}
+
+unsigned int tick_handler_get_tick_count(void)
+{
+    return Tick_Count; 
+}
+
 void tick_handler_init(void)
 {
+    int i; 
+
     interrupt_counter = 0; 
+    N_Interrupts = 0; 
+    Tick_Count = 0; 
+    for (i = 0; i < N_PRIORITY_LEVELS; i++)
+    {
+        Time_Slice_Ticks[i] = 0; 
+    }
+    Min_Time_Slice_Ticks = 0; 
+    Slice_Task_Id = TASK_ID_INVALID; 
+#ifdef TIMER_ONE_SHOT
+    Tickless = 0; 
+#endif
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
     interrupt_counter_max = 50; 
 #endif
@@ -165,7 +475,7 @@ void tick_handler_init(void)
     interrupt_char = 'a'; 
 
     timer_init(); 
-    time_storage_set_ms_per_tick(20); 
+    time_storage_set_us_per_tick(timer_get_us_per_tick()); 
 
 #if defined BUILD_X86_HOST || defined BUILD_X86_64_HOST
 
@@ -178,14 +488,14 @@ void tick_handler_init(void)
     /* register the multimedia timer interrupt handler */ 
     res = timeGetDevCaps(&timecaps, sizeof(timecaps)); 
     timeBeginPeriod(timecaps.wPeriodMin); 
-    timerid = timeSetEvent(20, timecaps.wPeriodMin, &tick_handler_function, 0, TIME_PERIODIC); 
+    timerid = timeSetEvent(timer_get_us_per_tick() / 1000, timecaps.wPeriodMin, &tick_handler_function, 0, TIME_PERIODIC); 
 
 #else
 
 // Linux host (default)
 
     /* register the signal handler */ 
-    signal(SIGVTALRM, tick_handler_function); 
+    interrupt_set_handler(TIMER_SIGNAL, tick_handler_function); 
 
 #endif
 
@@ -195,3 +505,8 @@ void tick_handler_init(void)
 }
 
 
+
+void tick_handler_set_poll_function(int (*poll_function)(void))
+{
+    Poll_Function = poll_function; 
+}
@@ -25,5 +25,63 @@
    for periodic interrupts */ 
 void tick_handler_init(void); 
 
+/* tick_handler_set_tickless: selects tickless mode, where 
+   the timer interrupts only when a waiting time expires, 
+   if tickless is nonzero, and periodic mode otherwise. 
+   Tickless mode is available on the Linux host. On other 
+   hosts and targets, periodic mode is always used. */ 
+void tick_handler_set_tickless(int tickless); 
+
+/* tick_handler_set_tick_rate: sets the number of 
+   periodic timer interrupts per second, which is also the 
+   resolution of waiting times in tickless mode. The rate 
+   can be selected on the Linux host. Shall be called 
+   before any task waits for time to expire. Returns 0, or -1 
+   if the rate is not accepted, see timer_set_tick_rate, or 
+   cannot be selected. */ 
+int tick_handler_set_tick_rate(int n_ticks_per_sec); 
+
+/* tick_handler_set_time_slice: sets the time quantum, in 
+   ticks, for tasks with priority priority. When the running 
+   task has run for its quantum, it is moved last among the 
+   ready tasks with the same priority. A quantum of 0, which 
+   is the default, turns time slicing off for the priority. 
+   In tickless mode, the timer interrupts at least once 
+   per smallest quantum, when time slicing is used. */ 
+void tick_handler_set_time_slice(int priority, int n_ticks); 
+
+/* tick_handler_update_time: registers, in tickless mode, 
+   the ticks elapsed since the last timer interrupt, and 
+   moves tasks whose waiting time has expired to the ready 
+   list. Returns the number of moved tasks. Shall be called 
+   with interrupts disabled, before the current time is read 
+   or a task is inserted in the time list. */ 
+int tick_handler_update_time(void); 
+
+/* tick_handler_update_timer: arms the timer, in tickless 
+   mode, for the first expiry in the time list. Shall be 
+   called with interrupts disabled, after a task has been 
+   inserted in the time list. */ 
+void tick_handler_update_timer(void); 
+
+/* tick_handler_set_poll_function: sets a function, called at 
+   each timer interrupt, with interrupts disabled, which checks 
+   for input, e.g. from a device without its own interrupt. The 
+   function returns the number of tasks it has made ready, and 
+   shall not call schedule. A poll_function of 0 removes the 
+   function. In tickless mode, the function is called only when 
+   the timer interrupts. */ 
+void tick_handler_set_poll_function(int (*poll_function)(void)); 
+
+/* tick_handler_get_n_interrupts: returns the number of 
+   handled timer interrupts */ 
+unsigned long tick_handler_get_n_interrupts(void); 
+
+/* tick_handler_get_tick_count: returns the number of registered 
+   ticks, which wraps around. In tickless mode, the ticks since 
+   the last timer interrupt are registered by 
+   tick_handler_update_time. */ 
+unsigned int tick_handler_get_tick_count(void); 
+
 #endif
 
@@ -26,6 +26,7 @@
 #include "tcb_storage.h"
 #include "ready_list.h"
 #include "schedule.h"
+#include "tick_handler.h"
 
 /* set_wait_ticks_running: sets number of wait 
    ticks in TCB for the running task */ 
@@ -55,10 +56,52 @@ static void move_running_to_time_list(void)
 
 void time_handler_wait_n_ticks(int n_ticks)
 {
+    /* bring the time up to date, so that the waiting 
+       time is counted from the current tick */ 
+    tick_handler_update_time(); 
     /* set the wait ticks */ 
     set_wait_ticks_running(n_ticks); 
     /* move running task to time list */ 
     move_running_to_time_list(); 
+    /* the waiting time may expire before the 
+       next timer interrupt */ 
+    tick_handler_update_timer(); 
     /* make another task run */ 
     schedule(); 
 }
+
+void time_handler_start_timeout(int n_ticks)
+{
+    /* bring the time up to date, so that the timeout 
+       is counted from the current tick */ 
+    tick_handler_update_time(); 
+    set_wait_ticks_running(n_ticks); 
+    tcb_storage_get_tcb_ref(task_get_task_id_running())->timed_out = 0; 
+    time_list_insert(task_get_task_id_running()); 
+    /* the timeout may expire before the next timer interrupt */ 
+    tick_handler_update_timer(); 
+}
+
+int time_handler_has_timed_out(void)
+{
+    return tcb_storage_get_tcb_ref(task_get_task_id_running())->timed_out; 
+}
+
+unsigned int time_handler_get_expiry_tick(int n_ticks)
+{
+    /* bring the time up to date, so that the expiry 
+       is counted from the current tick */ 
+    tick_handler_update_time(); 
+    return tick_handler_get_tick_count() + n_ticks; 
+}
+
+int time_handler_get_ticks_left(unsigned int expiry_tick)
+{
+    /* the number of ticks left, which is negative 
+       when expiry_tick has passed */ 
+    int n_ticks_left; 
+
+    tick_handler_update_time(); 
+    n_ticks_left = (int) (expiry_tick - tick_handler_get_tick_count()); 
+    return n_ticks_left > 0 ? n_ticks_left : 0; 
+}
@@ -25,4 +25,30 @@
    task wait n_ticks ticks */ 
 void time_handler_wait_n_ticks(int n_ticks); 
 
+/* value of n_ticks for time_handler_start_timeout, 
+   and for functions which wait with a timeout, to 
+   indicate that there is no timeout */ 
+#define TIME_HANDLER_WAIT_FOREVER -1
+
+/* time_handler_start_timeout: inserts the calling task, which 
+   shall have been moved to a wait list, in the time list, so 
+   that it stops waiting after n_ticks ticks. The task is removed 
+   from the time list when it is removed from the wait list. */ 
+void time_handler_start_timeout(int n_ticks); 
+
+/* time_handler_has_timed_out: returns nonzero if the calling 
+   task stopped waiting because its timeout expired */ 
+int time_handler_has_timed_out(void); 
+
+/* time_handler_get_expiry_tick: returns the tick at which a 
+   timeout of n_ticks, counted from the current tick, expires. 
+   Shall be called with interrupts disabled. */ 
+unsigned int time_handler_get_expiry_tick(int n_ticks); 
+
+/* time_handler_get_ticks_left: returns the number of ticks 
+   until expiry_tick, as returned by time_handler_get_expiry_tick, 
+   or 0 if it has passed. Shall be called with interrupts 
+   disabled. */ 
+int time_handler_get_ticks_left(unsigned int expiry_tick); 
+
 #endif
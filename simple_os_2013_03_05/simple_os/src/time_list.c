@@ -22,46 +22,155 @@
 #include "tcb_storage.h"
 #include "task_id_list.h"
 #include "tcb.h"
-#include "tcb_list.h"
 
 #include "console.h"
 
-/* size of time-list */ 
-#define TIME_LIST_SIZE TCB_LIST_SIZE
+/* fig_begin time_list */ 
+/* the list of tasks waiting for time to expire, linked 
+   through the TCBs and sorted by the tick number when 
+   the waiting time expires, so that a tick only needs to 
+   look at the first tasks in the list */ 
+static int Time_List_First; 
+static int Time_List_Last; 
 
-/* the list of processes waiting for time to expire */ 
-static int Time_List[TIME_LIST_SIZE]; 
+/* the number of registered ticks */ 
+static unsigned int Time_List_Tick; 
+/* fig_end time_list */ 
+
+/* tick_is_before: returns nonzero if tick_1 is before 
+   tick_2, also when the tick counter has wrapped around */ 
+static int tick_is_before(unsigned int tick_1, unsigned int tick_2)
+{
+    return (int) (tick_1 - tick_2) < 0; 
+}
 
 void time_list_init(void)
 {
-    task_id_list_reset(Time_List, TIME_LIST_SIZE); 
+    Time_List_First = TASK_ID_INVALID; 
+    Time_List_Last = TASK_ID_INVALID; 
+    Time_List_Tick = 0; 
 }
 
-void time_list_insert(int pid)
+void time_list_insert(int task_id)
 {
-    task_id_list_insert(Time_List, TIME_LIST_SIZE, pid); 
+    /* the TCB for the task to insert */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    /* task id for the task after which task_id is inserted */ 
+    int prev_task_id = Time_List_Last; 
+
+    tcb->wakeup_tick = Time_List_Tick + tcb->wait_ticks; 
+
+    /* search from the end of the list, for the last task 
+       which wakes up at the same tick or earlier */ 
+    while (prev_task_id != TASK_ID_INVALID && 
+           tick_is_before(tcb->wakeup_tick, 
+               tcb_storage_get_tcb_ref(prev_task_id)->wakeup_tick))
+    {
+        prev_task_id = 
+            tcb_storage_get_tcb_ref(prev_task_id)->time_prev_task_id; 
+    }
+
+    /* link the task into the list, after prev_task_id */ 
+    tcb->time_prev_task_id = prev_task_id; 
+    if (prev_task_id == TASK_ID_INVALID)
+    {
+        tcb->time_next_task_id = Time_List_First; 
+        Time_List_First = task_id; 
+    }
+    else
+    {
+        tcb->time_next_task_id = 
+            tcb_storage_get_tcb_ref(prev_task_id)->time_next_task_id; 
+        tcb_storage_get_tcb_ref(prev_task_id)->time_next_task_id = task_id; 
+    }
+    if (tcb->time_next_task_id == TASK_ID_INVALID)
+    {
+        Time_List_Last = task_id; 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(tcb->time_next_task_id)->time_prev_task_id = 
+            task_id; 
+    }
+    tcb->is_timed = 1; 
 }
 
-void time_list_remove(int pid)
+void time_list_remove(int task_id)
 {
-    task_id_list_remove(Time_List, TIME_LIST_SIZE, pid); 
+    /* the TCB for the task to remove */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+
+    /* nothing to do if the task is not in the time list */ 
+    if (!tcb->is_timed)
+    {
+        return; 
+    }
+
+    /* unlink the task from its neighbours */ 
+    if (tcb->time_prev_task_id == TASK_ID_INVALID)
+    {
+        Time_List_First = tcb->time_next_task_id; 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(tcb->time_prev_task_id)->time_next_task_id = 
+            tcb->time_next_task_id; 
+    }
+    if (tcb->time_next_task_id == TASK_ID_INVALID)
+    {
+        Time_List_Last = tcb->time_prev_task_id; 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(tcb->time_next_task_id)->time_prev_task_id = 
+            tcb->time_prev_task_id; 
+    }
+    tcb->time_next_task_id = TASK_ID_INVALID; 
+    tcb->time_prev_task_id = TASK_ID_INVALID; 
+    tcb->is_timed = 0; 
     // console_put_string("time_removed "); 
-    // console_put_hex(pid); 
+    // console_put_hex(task_id); 
 }
 
-void time_list_decrement_timers(int *n_new_tasks_ready, int new_task_ids_ready[])
+void time_list_register_tick(void)
 {
-    /* a pointer to a TCB, to be used as a pointer
-       to the common TCB list */ 
-    task_control_block *tcb_list_ref; 
-
-    /* get a pointer to the common TCB list */  
-    tcb_list_ref = tcb_storage_get_tcb_list_ref(); 
-
-    /* decrement timers */ 
-    tcb_list_decrement_timers(
-        tcb_list_ref, tcb_storage_get_tcb_list_size(), 
-        Time_List, TIME_LIST_SIZE, 
-        n_new_tasks_ready, new_task_ids_ready);
+    Time_List_Tick++; 
 }
 
+void time_list_register_ticks(unsigned int n_ticks)
+{
+    Time_List_Tick += n_ticks; 
+}
+
+int time_list_get_ticks_to_next_expiry(void)
+{
+    /* the number of ticks until the first task wakes up */ 
+    int n_ticks; 
+
+    if (Time_List_First == TASK_ID_INVALID)
+    {
+        return -1; 
+    }
+    n_ticks = (int) (tcb_storage_get_tcb_ref(Time_List_First)->wakeup_tick - 
+                     Time_List_Tick); 
+    return n_ticks < 0 ? 0 : n_ticks; 
+}
+
+int time_list_remove_expired(void)
+{
+    /* the first task in the list is the first to wake up */ 
+    int task_id = Time_List_First; 
+
+    if (task_id == TASK_ID_INVALID || 
+        tick_is_before(Time_List_Tick, 
+            tcb_storage_get_tcb_ref(task_id)->wakeup_tick))
+    {
+        /* no waiting time has expired */ 
+        return TASK_ID_INVALID; 
+    }
+
+    // console_put_string("END WAIT for tid: "); 
+    // console_put_hex(task_id);  
+    time_list_remove(task_id); 
+    return task_id; 
+}
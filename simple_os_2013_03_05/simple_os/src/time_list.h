@@ -21,17 +21,35 @@
 #ifndef TIME_LIST_H
 #define TIME_LIST_H
 
+/* time_list_insert: inserts task_id in the list of tasks 
+   waiting for time to expire. The task waits for the number 
+   of ticks given by wait_ticks in its TCB. */ 
 void time_list_insert(int task_id); 
 
+/* time_list_remove: removes task_id from the time list, 
+   if it is stored there */ 
 void time_list_remove(int task_id); 
 
-/* time_list_decrement_timers: decrements timers for
-   tasks waiting for time to expire. The number 
-   of tasks ready to run after the timers are 
-   decremented are stored in *n_new_taks_ready, and 
-   the tasks ids for these tasks are stored in 
-   new_task_ids_ready */ 
-void time_list_decrement_timers(int *n_new_tasks_ready, int new_task_ids_ready[]); 
+/* time_list_register_tick: registers a tick, so that 
+   waiting times which expire at this tick can be 
+   removed by time_list_remove_expired */ 
+void time_list_register_tick(void); 
+
+/* time_list_register_ticks: registers n_ticks ticks, 
+   as when calling time_list_register_tick n_ticks times */ 
+void time_list_register_ticks(unsigned int n_ticks); 
+
+/* time_list_get_ticks_to_next_expiry: returns the number 
+   of ticks until the first waiting time in the list expires, 
+   or -1 if the list is empty. Zero is returned if the 
+   waiting time has already expired. */ 
+int time_list_get_ticks_to_next_expiry(void); 
+
+/* time_list_remove_expired: removes one task whose 
+   waiting time has expired from the time list, and returns 
+   its task id. TASK_ID_INVALID is returned if there is 
+   no such task. */ 
+int time_list_remove_expired(void); 
 
 void time_list_init(void); 
 
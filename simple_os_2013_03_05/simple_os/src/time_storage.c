@@ -21,42 +21,73 @@
 #include "time_storage.h"
 
 #include "si_time_type.h"
+#include "timer.h"
 
-static int Ms_Per_Tick = 1; 
+static long Us_Per_Tick = 1000000 / TIMER_TICK_RATE_HZ; 
 
 static si_time Current_Time; 
 
+/* microseconds of registered ticks, which are 
+   not yet added to Current_Time */ 
+static long Current_Us; 
+
 static int N_Ticks = 0; 
 
 #define MAX_N_TICKS 0x8FFFFFFF
 
-void time_storage_set_ms_per_tick(int ms_per_tick)
+void time_storage_set_us_per_tick(long us_per_tick)
 {
-    Ms_Per_Tick = ms_per_tick; 
+    Us_Per_Tick = us_per_tick; 
 }
 
-int time_storage_get_ms_per_tick(void)
+long time_storage_get_us_per_tick(void)
 {
-    return Ms_Per_Tick; 
+    return Us_Per_Tick; 
 }
 
 void time_storage_register_tick(void)
 {
-    N_Ticks++; 
-    if (N_Ticks == MAX_N_TICKS)
-    {
-	N_Ticks = 0; 
-    }
-    si_time_add_n_ms(&Current_Time, Ms_Per_Tick); 
+    time_storage_register_ticks(1); 
+}
+
+void time_storage_register_ticks(int n_ticks)
+{
+    N_Ticks = (int) (((unsigned int) N_Ticks + n_ticks) % MAX_N_TICKS); 
+    Current_Us += n_ticks * Us_Per_Tick; 
+    si_time_add_n_ms(&Current_Time, (int) (Current_Us / 1000)); 
+    Current_Us %= 1000; 
 }
 
 void time_storage_get_current_time(si_time *time)
 {
+#ifdef TIMER_CLOCK
+    /* read the clock which drives the timer, so that 
+       the time does not drift, e.g. due to lost ticks */ 
+    long long time_us = timer_get_time_us(); 
+    si_time_set(time, (int) (time_us / 1000000), 
+                (int) (time_us / 1000 % 1000)); 
+#else
     *time = Current_Time; 
+#endif
+}
+
+long long time_storage_get_time_us(void)
+{
+#ifdef TIMER_CLOCK
+    return timer_get_time_us(); 
+#else
+    return time_storage_get_tick_time_us(); 
+#endif
+}
+
+long long time_storage_get_tick_time_us(void)
+{
+    return (Current_Time.n_sec * 1000LL + Current_Time.n_ms) * 1000 + 
+        Current_Us; 
 }
 
 void time_storage_init(void)
 {
     si_time_set(&Current_Time, 0, 0); 
+    Current_Us = 0; 
 }
-
@@ -23,23 +23,36 @@
 
 #include "si_time_type.h"
 
-/* time_storage_set_ms_per_tick: sets number of 
-   milliseconds in one tick */ 
-void time_storage_set_ms_per_tick(int ms_per_tick); 
+/* time_storage_set_us_per_tick: sets number of 
+   microseconds in one tick */ 
+void time_storage_set_us_per_tick(long us_per_tick); 
 
-/* time_storage_get_ms_per_tick: returns number of 
-   milliseconds in one tick */ 
-int time_storage_get_ms_per_tick(void); 
+/* time_storage_get_us_per_tick: returns number of 
+   microseconds in one tick */ 
+long time_storage_get_us_per_tick(void); 
 
 /* time_storage_register_tick: registers a tick, 
    e.g. for the purpose of keeping track of the 
    current time */ 
 void time_storage_register_tick(void); 
 
+/* time_storage_register_ticks: registers n_ticks ticks */ 
+void time_storage_register_ticks(int n_ticks); 
+
 /* time_storage_get_current_time: returns the current 
-   time in *time */ 
+   time in *time. On the Linux host, the time is read 
+   from the clock which drives the timer. */ 
 void time_storage_get_current_time(si_time *time); 
 
+/* time_storage_get_time_us: returns the current time, 
+   in microseconds. On the Linux host, the time is read 
+   from the clock which drives the timer. */ 
+long long time_storage_get_time_us(void); 
+
+/* time_storage_get_tick_time_us: returns the time of the 
+   latest registered tick, in microseconds */ 
+long long time_storage_get_tick_time_us(void); 
+
 /* time_storage_init: performs initialisation */ 
 void time_storage_init(void); 
 
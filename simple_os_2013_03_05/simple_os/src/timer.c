@@ -30,23 +30,158 @@ void timer_init(void)
 {
 }
 
+long timer_get_us_per_tick(void)
+{
+    return 1000000 / TIMER_TICK_RATE_HZ; 
+}
+
 #else 
 
-#include <sys/time.h>
+#include <time.h>
 #include <signal.h>
+#include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+#ifdef SMP_HOST
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+/* the number of microseconds between periodic timer interrupts */ 
+static long Us_Per_Tick = 1000000 / TIMER_TICK_RATE_HZ; 
+
+/* the timer, which is created when timer_init is first called */ 
+static timer_t Timer_Id; 
+static int Timer_Created = 0; 
+
+/* the time when timer_init was first called */ 
+static struct timespec Start_Time; 
+
+/* timer_error: reports that the host timer function 
+   function_name failed, and stops, since the kernel 
+   cannot run without timer interrupts */ 
+static void timer_error(const char *function_name)
+{
+    console_put_string("Simple_OS: timer error in "); 
+    console_put_string(function_name); 
+    console_put_string("\n"); 
+    exit(1); 
+}
 
-static struct itimerval timer_value; 
+/* set_abs_time: sets *abs_time to the monotonic clock time 
+   corresponding to time_us, as returned by timer_get_time_us */ 
+static void set_abs_time(struct timespec *abs_time, long long time_us)
+{
+    abs_time->tv_sec = Start_Time.tv_sec + time_us / 1000000; 
+    abs_time->tv_nsec = Start_Time.tv_nsec + (time_us % 1000000) * 1000; 
+    if (abs_time->tv_nsec >= 1000000000)
+    {
+        abs_time->tv_sec++; 
+        abs_time->tv_nsec -= 1000000000; 
+    }
+}
 
 void timer_init(void)
 {
-    /* set up timer interval, selecting a frequency of 50 Hz */ 
-    timer_value.it_interval.tv_sec = 0; 
-    timer_value.it_interval.tv_usec = 20000; 
-    timer_value.it_value = timer_value.it_interval; 
+    /* the notification, by signal, when the timer expires */ 
+    struct sigevent event; 
+    /* the start time and interval of the timer */ 
+    struct itimerspec timer_value; 
+
+    if (!Timer_Created)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &Start_Time); 
+        memset(&event, 0, sizeof(event)); 
+#ifdef SMP_HOST
+        /* the timer interrupts are handled by CPU 0, which 
+           is the thread calling timer_init */ 
+        event.sigev_notify = SIGEV_THREAD_ID; 
+        event._sigev_un._tid = syscall(SYS_gettid); 
+#else
+        event.sigev_notify = SIGEV_SIGNAL; 
+#endif
+        event.sigev_signo = TIMER_SIGNAL; 
+        if (timer_create(CLOCK_MONOTONIC, &event, &Timer_Id) != 0)
+        {
+            timer_error("timer_create"); 
+        }
+        Timer_Created = 1; 
+    }
+
+    /* start at the next multiple of the interval, so that 
+       the interrupts are aligned with timer_get_time_us */ 
+    set_abs_time(&timer_value.it_value, 
+        (timer_get_time_us() / Us_Per_Tick + 1) * Us_Per_Tick); 
+    timer_value.it_interval.tv_sec = Us_Per_Tick / 1000000; 
+    timer_value.it_interval.tv_nsec = (Us_Per_Tick % 1000000) * 1000; 
 
     /* initialise the timer */ 
-    setitimer(ITIMER_VIRTUAL, &timer_value, 0); 
+    if (timer_settime(Timer_Id, TIMER_ABSTIME, &timer_value, NULL) != 0)
+    {
+        timer_error("timer_settime"); 
+    }
+}
+
+long timer_get_us_per_tick(void)
+{
+    return Us_Per_Tick; 
+}
+
+int timer_set_tick_rate(int n_ticks_per_sec)
+{
+    /* the time between ticks is counted in whole microseconds, 
+       so a rate which does not divide one second would make 
+       the ticks drift from the clock */ 
+    if (n_ticks_per_sec < TIMER_MIN_TICK_RATE_HZ || 
+        n_ticks_per_sec > TIMER_MAX_TICK_RATE_HZ || 
+        1000000 % n_ticks_per_sec != 0)
+    {
+        return -1; 
+    }
+    Us_Per_Tick = 1000000 / n_ticks_per_sec; 
+    return 0; 
+}
+
+int timer_get_overrun(void)
+{
+    /* the number of lost timer interrupts */ 
+    int n_overrun = timer_getoverrun(Timer_Id); 
+
+    return n_overrun > 0 ? n_overrun : 0; 
+}
+
+long long timer_get_time_us(void)
+{
+    struct timespec now; 
+
+    clock_gettime(CLOCK_MONOTONIC, &now); 
+    return (now.tv_sec - Start_Time.tv_sec) * 1000000LL + 
+        (now.tv_nsec - Start_Time.tv_nsec) / 1000; 
+}
+
+long long timer_get_time_ns(void)
+{
+    struct timespec now; 
+
+    clock_gettime(CLOCK_MONOTONIC, &now); 
+    return (now.tv_sec - Start_Time.tv_sec) * 1000000000LL + 
+        (now.tv_nsec - Start_Time.tv_nsec); 
+}
+
+void timer_set_one_shot(long long time_us)
+{
+    /* the expiry time of the timer, with no interval */ 
+    struct itimerspec timer_value; 
+
+    set_abs_time(&timer_value.it_value, time_us); 
+    timer_value.it_interval.tv_sec = 0; 
+    timer_value.it_interval.tv_nsec = 0; 
+
+    if (timer_settime(Timer_Id, TIMER_ABSTIME, &timer_value, NULL) != 0)
+    {
+        timer_error("timer_settime"); 
+    }
 }
 
 #endif
@@ -123,4 +258,10 @@ void timer_init(void)
         console_put_string("timer initialised"); 
 }
 
+long timer_get_us_per_tick(void)
+{
+    /* 50 Hz, as set up in timer_init */ 
+    return 20000; 
+}
+
 #endif
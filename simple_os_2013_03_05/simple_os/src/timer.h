@@ -21,6 +21,68 @@
 #ifndef TIMER_H
 #define TIMER_H
 
+/* the default number of periodic timer interrupts 
+   per second */ 
+#ifndef TIMER_TICK_RATE_HZ
+#define TIMER_TICK_RATE_HZ 50
+#endif
+
+/* the range of selectable tick rates, on the Linux host */ 
+#define TIMER_MIN_TICK_RATE_HZ 50
+#define TIMER_MAX_TICK_RATE_HZ 10000
+
+/* timer_init: starts periodic timer interrupts */ 
 void timer_init(void); 
 
+/* timer_get_us_per_tick: returns the number of 
+   microseconds between periodic timer interrupts */ 
+long timer_get_us_per_tick(void); 
+
+#if (defined BUILD_X86_HOST || defined BUILD_X86_64_HOST) && \
+    !defined BUILD_X86_WIN_HOST
+
+#include <signal.h>
+
+/* the signal used for timer interrupts. The timer 
+   runs in real time, also when the process sleeps. */ 
+#define TIMER_SIGNAL SIGALRM
+
+/* the timer provides a monotonic clock, which is 
+   read by timer_get_time_us */ 
+#define TIMER_CLOCK
+
+/* the timer can be used in one-shot mode, which is 
+   needed for tickless operation */ 
+#define TIMER_ONE_SHOT
+
+/* timer_set_tick_rate: sets the number of periodic timer 
+   interrupts per second, in the range from TIMER_MIN_TICK_RATE_HZ 
+   to TIMER_MAX_TICK_RATE_HZ, which shall divide 1000000, so that 
+   the time between interrupts is a whole number of microseconds. 
+   The rate is used from the next call to timer_init. Returns 0, 
+   or -1 if the rate is not accepted, and then is not changed. */ 
+int timer_set_tick_rate(int n_ticks_per_sec); 
+
+/* timer_get_overrun: returns the number of periodic timer 
+   interrupts which were lost before the latest handled 
+   interrupt, e.g. since interrupts were disabled */ 
+int timer_get_overrun(void); 
+
+/* timer_get_time_us: returns the number of microseconds 
+   since timer_init was first called, read from a 
+   monotonic clock */ 
+long long timer_get_time_us(void); 
+
+/* timer_get_time_ns: returns the number of nanoseconds 
+   since timer_init was first called, read from a 
+   monotonic clock */ 
+long long timer_get_time_ns(void); 
+
+/* timer_set_one_shot: stops periodic timer interrupts, 
+   if started, and arms the timer for one interrupt, at 
+   the time time_us, as returned by timer_get_time_us */ 
+void timer_set_one_shot(long long time_us); 
+
+#endif
+
 #endif
@@ -0,0 +1,115 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+#include "wait_any.h"
+
+#include "tcb.h"
+#include "tcb_storage.h"
+#include "ready_list.h"
+#include "time_list.h"
+
+void wait_any_list_reset(wait_any_list_type *wait_any_list)
+{
+    wait_any_list->first = 0; 
+    wait_any_list->last = 0; 
+}
+
+void wait_any_list_insert(
+    wait_any_list_type *wait_any_list, wait_any_node_type *node, int task_id)
+{
+    node->task_id = task_id; 
+    node->list = wait_any_list; 
+    node->next = 0; 
+    node->prev = wait_any_list->last; 
+    if (wait_any_list->last == 0)
+    {
+        wait_any_list->first = node; 
+    }
+    else
+    {
+        wait_any_list->last->next = node; 
+    }
+    wait_any_list->last = node; 
+}
+
+/* wait_any_list_remove: removes node from its list */ 
+static void wait_any_list_remove(wait_any_node_type *node)
+{
+    if (node->prev == 0)
+    {
+        node->list->first = node->next; 
+    }
+    else
+    {
+        node->prev->next = node->next; 
+    }
+    if (node->next == 0)
+    {
+        node->list->last = node->prev; 
+    }
+    else
+    {
+        node->next->prev = node->prev; 
+    }
+    node->next = 0; 
+    node->prev = 0; 
+    node->list = 0; 
+}
+
+int wait_any_list_notify(wait_any_list_type *wait_any_list)
+{
+    /* a node in the list */ 
+    wait_any_node_type *node; 
+    /* number of tasks made ready */ 
+    int n_ready = 0; 
+
+    for (node = wait_any_list->first; node != 0; node = node->next)
+    {
+        /* the task may already have been made ready 
+           by another of its objects */ 
+        if (!tcb_storage_get_tcb_ref(node->task_id)->is_ready)
+        {
+            time_list_remove(node->task_id); 
+            ready_list_insert(node->task_id); 
+            n_ready++; 
+        }
+    }
+    return n_ready; 
+}
+
+void wait_any_set_nodes(int task_id, wait_any_node_type nodes[], int n_nodes)
+{
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+
+    tcb->wait_any_nodes = nodes; 
+    tcb->n_wait_any_nodes = n_nodes; 
+}
+
+void wait_any_remove_nodes(int task_id)
+{
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    int i; 
+
+    for (i = 0; i < tcb->n_wait_any_nodes; i++)
+    {
+        wait_any_list_remove(&tcb->wait_any_nodes[i]); 
+    }
+    tcb->wait_any_nodes = 0; 
+    tcb->n_wait_any_nodes = 0; 
+}
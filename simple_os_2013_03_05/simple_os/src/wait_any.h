@@ -0,0 +1,70 @@
+/* This file is part of Simple_OS, a real-time operating system  */
+/* designed for research and education */
+/* Copyright (c) 2003-2013 Ola Dahl */
+
+/* The software accompanies the book Into Realtime, available at  */
+/* http://theintobooks.com */
+
+/* Simple_OS is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* This program is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+#ifndef WAIT_ANY_H
+#define WAIT_ANY_H
+
+/* data type for a node, by which a task waits in si_wait_any 
+   for one of several objects. A node is stored in a list of 
+   the object, and is linked with the other nodes in the list. */ 
+typedef struct wait_any_node_struct
+{
+    /* the next and previous node in the list */ 
+    struct wait_any_node_struct *next; 
+    struct wait_any_node_struct *prev; 
+    /* the list where the node is stored */ 
+    struct wait_any_list_struct *list; 
+    /* task id for the waiting task */ 
+    int task_id; 
+} wait_any_node_type; 
+
+/* data type for the list of nodes for the tasks which wait 
+   for an object in si_wait_any, in the order they started 
+   to wait */ 
+typedef struct wait_any_list_struct
+{
+    /* the first and last node, or 0 */ 
+    wait_any_node_type *first; 
+    wait_any_node_type *last; 
+} wait_any_list_type; 
+
+/* wait_any_list_reset: makes wait_any_list empty */ 
+void wait_any_list_reset(wait_any_list_type *wait_any_list); 
+
+/* wait_any_list_insert: inserts node, for task_id, 
+   last in wait_any_list */ 
+void wait_any_list_insert(
+    wait_any_list_type *wait_any_list, wait_any_node_type *node, int task_id); 
+
+/* wait_any_list_notify: makes the tasks which wait in 
+   wait_any_list ready, and removes them from the time list, 
+   if they wait with a timeout. The nodes are removed by the 
+   waiting tasks. Returns the number of tasks made ready. */ 
+int wait_any_list_notify(wait_any_list_type *wait_any_list); 
+
+/* wait_any_set_nodes: registers the n_nodes nodes in nodes, 
+   which have been inserted for task_id, so that they can be 
+   removed by wait_any_remove_nodes */ 
+void wait_any_set_nodes(int task_id, wait_any_node_type nodes[], int n_nodes); 
+
+/* wait_any_remove_nodes: removes the nodes registered for 
+   task_id from their lists */ 
+void wait_any_remove_nodes(int task_id); 
+
+#endif
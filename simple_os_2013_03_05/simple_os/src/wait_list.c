@@ -21,52 +21,161 @@
 #include "wait_list.h"
 
 #include "tcb_storage.h"
-#include "tcb_list.h"
 #include "tcb.h"
 #include "task_id_list.h"
+#include "time_list.h"
 
-void wait_list_reset(int wait_list[], int length)
+void wait_list_reset(wait_list_type *wait_list)
 {
-    task_id_list_reset(wait_list, length); 
+    wait_list->first_task_id = TASK_ID_INVALID; 
+    wait_list->last_task_id = TASK_ID_INVALID; 
 }
 
-/* wait_list_insert: inserts task_id in wait_list */ 
-void wait_list_insert(int wait_list[], int length, int task_id)
+/* get_priority: returns the priority of task_id */ 
+static int get_priority(int task_id)
 {
-    task_id_list_insert(wait_list, length, task_id); 
+    return tcb_storage_get_tcb_ref(task_id)->priority; 
 }
 
-int wait_list_is_empty(int wait_list[], int length)
+/* find_prev: returns the task id for the last task in wait_list 
+   with the same or higher priority than priority, or 
+   TASK_ID_INVALID if there is no such task */ 
+static int find_prev(wait_list_type *wait_list, int priority)
 {
-    return task_id_list_is_empty(wait_list, length); 
+    /* task id for the task after which a task is inserted */ 
+    int prev_task_id; 
+    /* task id for the task before which a task is inserted */ 
+    int next_task_id; 
+
+    if (wait_list->first_task_id == TASK_ID_INVALID)
+    {
+        return TASK_ID_INVALID; 
+    }
+
+    /* search from the end of the list which is nearest in 
+       priority, so that a task with the highest or lowest 
+       priority is inserted without searching */ 
+    if (priority - get_priority(wait_list->first_task_id) < 
+        get_priority(wait_list->last_task_id) - priority)
+    {
+        prev_task_id = TASK_ID_INVALID; 
+        next_task_id = wait_list->first_task_id; 
+        while (next_task_id != TASK_ID_INVALID && 
+               get_priority(next_task_id) <= priority)
+        {
+            prev_task_id = next_task_id; 
+            next_task_id = tcb_storage_get_tcb_ref(next_task_id)->next_task_id; 
+        }
+    }
+    else
+    {
+        prev_task_id = wait_list->last_task_id; 
+        while (prev_task_id != TASK_ID_INVALID && 
+               get_priority(prev_task_id) > priority)
+        {
+            prev_task_id = tcb_storage_get_tcb_ref(prev_task_id)->prev_task_id; 
+        }
+    }
+    return prev_task_id; 
 }
 
-int wait_list_remove_highest_prio(int wait_list[], int length)
+/* wait_list_insert: inserts task_id in wait_list */ 
+void wait_list_insert(wait_list_type *wait_list, int task_id)
 {
-    /* a pointer to a TCB, to be used as a pointer
-       to the common TCB list */ 
-    task_control_block *tcb_list_ref; 
-
-    /* task_id for task with highest priority */ 
-    int task_id_highest_prio; 
+    /* the TCB for the task to insert */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+    /* task id for the task after which task_id is inserted */ 
+    int prev_task_id = find_prev(wait_list, tcb->priority); 
+
+    /* link the task into the list, after prev_task_id */ 
+    tcb->wait_list = wait_list; 
+    tcb->prev_task_id = prev_task_id; 
+    if (prev_task_id == TASK_ID_INVALID)
+    {
+        tcb->next_task_id = wait_list->first_task_id; 
+        wait_list->first_task_id = task_id; 
+    }
+    else
+    {
+        tcb->next_task_id = 
+            tcb_storage_get_tcb_ref(prev_task_id)->next_task_id; 
+        tcb_storage_get_tcb_ref(prev_task_id)->next_task_id = task_id; 
+    }
+    if (tcb->next_task_id == TASK_ID_INVALID)
+    {
+        wait_list->last_task_id = task_id; 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(tcb->next_task_id)->prev_task_id = task_id; 
+    }
+}
 
-    /* get a pointer to the common TCB list */  
-    tcb_list_ref = tcb_storage_get_tcb_list_ref(); 
+int wait_list_is_empty(wait_list_type *wait_list)
+{
+    return wait_list->first_task_id == TASK_ID_INVALID; 
+}
 
-    /* get task_id for task with highest priority */ 
-    task_id_highest_prio = tcb_list_get_task_id_highest_prio(
-        tcb_list_ref, tcb_storage_get_tcb_list_size(), 
-        wait_list, length); 
+int wait_list_remove_highest_prio(wait_list_type *wait_list)
+{
+    /* task_id for task with highest priority */ 
+    int task_id_highest_prio = wait_list->first_task_id; 
 
     /* remove the task_id from wait_list */ 
-    task_id_list_remove(wait_list, length, task_id_highest_prio); 
+    wait_list_remove(wait_list, task_id_highest_prio); 
 
     /* return the task_id */ 
     return task_id_highest_prio; 
 }
 
-int wait_list_remove_one(int wait_list[], int length)
+int wait_list_remove_one(wait_list_type *wait_list)
 {
-    return task_id_list_remove_first(wait_list, length); 
+    return wait_list_remove_highest_prio(wait_list); 
 }
 
+/* unlink_task: removes task_id from wait_list */ 
+static void unlink_task(wait_list_type *wait_list, int task_id)
+{
+    /* the TCB for the task to remove */ 
+    task_control_block *tcb = tcb_storage_get_tcb_ref(task_id); 
+
+    /* unlink the task from its neighbours */ 
+    if (tcb->prev_task_id == TASK_ID_INVALID)
+    {
+        wait_list->first_task_id = tcb->next_task_id; 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(tcb->prev_task_id)->next_task_id = 
+            tcb->next_task_id; 
+    }
+    if (tcb->next_task_id == TASK_ID_INVALID)
+    {
+        wait_list->last_task_id = tcb->prev_task_id; 
+    }
+    else
+    {
+        tcb_storage_get_tcb_ref(tcb->next_task_id)->prev_task_id = 
+            tcb->prev_task_id; 
+    }
+    tcb->next_task_id = TASK_ID_INVALID; 
+    tcb->prev_task_id = TASK_ID_INVALID; 
+    tcb->wait_list = 0; 
+}
+
+void wait_list_remove(wait_list_type *wait_list, int task_id)
+{
+    unlink_task(wait_list, task_id); 
+
+    /* a task which waits with a timeout no longer waits for time */ 
+    time_list_remove(task_id); 
+}
+
+void wait_list_change_priority(
+    wait_list_type *wait_list, int task_id, int priority)
+{
+    /* move the task, so that the list stays sorted */ 
+    unlink_task(wait_list, task_id); 
+    tcb_storage_get_tcb_ref(task_id)->priority = priority; 
+    wait_list_insert(wait_list, task_id); 
+}
@@ -21,15 +21,49 @@
 #ifndef WAIT_LIST_H
 #define WAIT_LIST_H
 
-void wait_list_reset(int wait_list[], int length); 
+/* fig_begin wait_list_def */ 
+/* data type for a list of waiting tasks. The list is 
+   linked through the TCBs of the waiting tasks, and is 
+   sorted by priority, with tasks of equal priority 
+   stored in the order they were inserted */ 
+typedef struct wait_list_struct
+{
+    /* task id for the first task in the list, 
+       having the highest priority */ 
+    int first_task_id; 
+    /* task id for the last task in the list */ 
+    int last_task_id; 
+} wait_list_type; 
+/* fig_end wait_list_def */ 
 
-/* wait_list_insert: inserts task_id in wait_list */ 
-void wait_list_insert(int wait_list[], int length, int task_id); 
+/* wait_list_reset: makes wait_list empty */ 
+void wait_list_reset(wait_list_type *wait_list); 
 
-int wait_list_is_empty(int wait_list[], int length); 
+/* wait_list_insert: inserts task_id in wait_list, 
+   after all tasks with the same or higher priority */ 
+void wait_list_insert(wait_list_type *wait_list, int task_id); 
 
-int wait_list_remove_highest_prio(int wait_list[], int length); 
+/* wait_list_is_empty: returns nonzero if wait_list 
+   is empty */ 
+int wait_list_is_empty(wait_list_type *wait_list); 
 
-int wait_list_remove_one(int wait_list[], int length); 
+/* wait_list_remove_highest_prio: removes the task with 
+   highest priority from wait_list, and returns its task id */ 
+int wait_list_remove_highest_prio(wait_list_type *wait_list); 
+
+/* wait_list_remove_one: removes one task from wait_list, 
+   and returns its task id */ 
+int wait_list_remove_one(wait_list_type *wait_list); 
+
+/* wait_list_remove: removes task_id from wait_list, and 
+   from the time list, if the task waits with a timeout */ 
+void wait_list_remove(wait_list_type *wait_list, int task_id); 
+
+/* wait_list_change_priority: sets the priority of task_id, 
+   which is stored in wait_list, to priority, and moves it last 
+   among the tasks with the new priority. The task stays in the 
+   time list, if it waits with a timeout. */ 
+void wait_list_change_priority(
+    wait_list_type *wait_list, int task_id, int priority); 
 
 #endif
@@ -11,7 +11,7 @@ endif
 
 C_FLAGS +=-c -Wall
 INCLUDE_FLAGS = -I $(SIMPLE_OS_DIR)/src
-LIB_FLAGS =-L $(SIMPLE_OS_DIR) -lsimple_os_$(TARGET_SUFFIX)
+LIB_FLAGS =-L $(SIMPLE_OS_DIR) -lsimple_os_$(TARGET_SUFFIX) $(TARGET_LIBS)
 
 C_FILES = $(basename $(notdir $(wildcard src/*.c)))
 OBJECTS = $(addprefix obj/, $(addsuffix _$(TARGET_SUFFIX).o, $(C_FILES)))
@@ -75,7 +75,7 @@ void create_customers_task(void)
 
     for (i = 0; i < MAX_N_CUSTOMERS; i++)
     {
-        si_task_create(customer_task, &Customer_Stack[i][STACK_SIZE-1], customer_prio++); 
+        si_task_create_stack(customer_task, Customer_Stack[i], STACK_SIZE, customer_prio++); 
 
         si_wait_n_ms(customer_create_delay_sec * 1000 + 150); 
     }
@@ -95,9 +95,9 @@ int main(void)
     si_sem_init(&Create_Customers_Sem, 0); 
 
     /* create tasks */
-    si_task_create(barber_task, &Barber_Stack[STACK_SIZE-1], BARBER_PRIO); 
+    si_task_create_stack(barber_task, Barber_Stack, STACK_SIZE, BARBER_PRIO); 
    
-    si_task_create(create_customers_task, &Create_Customers_Stack[STACK_SIZE-1], CREATE_CUSTOMERS_PRIO); 
+    si_task_create_stack(create_customers_task, Create_Customers_Stack, STACK_SIZE, CREATE_CUSTOMERS_PRIO); 
 
     /* start the kernel */ 
     si_kernel_start(); 
@@ -85,7 +85,7 @@ void create_customers_task(void)
         {
             if (n_customers < MAX_N_CUSTOMERS)
             { 
-                si_task_create(customer_task, &Customer_Stack[n_customers][STACK_SIZE-1], customer_prio++); 
+                si_task_create_stack(customer_task, Customer_Stack[n_customers], STACK_SIZE, customer_prio++); 
                 n_customers++; 
             }
             else
@@ -125,9 +125,9 @@ int main(void)
 
     /* create tasks */
 
-    si_task_create(barber_task, &Barber_Stack[STACK_SIZE-1], BARBER_PRIO); 
+    si_task_create_stack(barber_task, Barber_Stack, STACK_SIZE, BARBER_PRIO); 
    
-    si_task_create(create_customers_task, &Create_Customers_Stack[STACK_SIZE-1], CREATE_CUSTOMERS_PRIO); 
+    si_task_create_stack(create_customers_task, Create_Customers_Stack, STACK_SIZE, CREATE_CUSTOMERS_PRIO); 
 
     /* start the kernel */ 
     si_kernel_start(); 
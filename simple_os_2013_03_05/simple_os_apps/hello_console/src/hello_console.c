@@ -33,7 +33,7 @@ int main(void)
     si_kernel_init(); 
 
     /* create task */
-    si_task_create(print_task, &Print_Task_Stack[STACK_SIZE-1], 10); 
+    si_task_create_stack(print_task, Print_Task_Stack, STACK_SIZE, 10); 
    
     /* start the kernel */ 
     si_kernel_start(); 
@@ -153,9 +153,9 @@ int main(void)
 
     /* create tasks */
 
-    si_task_create(print_task, &Print_Task_Stack[STACK_SIZE-1], 15); 
+    si_task_create_stack(print_task, Print_Task_Stack, STACK_SIZE, 15); 
    
-    si_task_create(read_task, &Read_Task_Stack[STACK_SIZE-1], 10); 
+    si_task_create_stack(read_task, Read_Task_Stack, STACK_SIZE, 10); 
    
     /* start the kernel */ 
     si_kernel_start(); 